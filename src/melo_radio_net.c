@@ -18,6 +18,7 @@
 #include <stddef.h>
 
 #include <melo/melo_module.h>
+#include <melo/melo_settings.h>
 
 #define MELO_LOG_TAG "melo_radio_net"
 #include <melo/melo_log.h>
@@ -28,18 +29,129 @@
 
 static MeloRadioNetBrowser *browser;
 
+static MeloSettings *settings;
+static MeloSettingsEntry *entry_urls;
+static MeloSettingsEntry *entry_asset_urls;
+static MeloSettingsEntry *entry_budget;
+
+static bool
+melo_radio_net_set_endpoints (char **error)
+{
+  const char *urls = NULL, *asset_urls = NULL;
+
+  /* Get endpoint lists: empty for default */
+  melo_settings_entry_get_string (entry_urls, &urls, NULL);
+  melo_settings_entry_get_string (entry_asset_urls, &asset_urls, NULL);
+
+  /* Apply endpoint lists */
+  if (!melo_radio_net_browser_set_endpoints (browser,
+          urls && *urls ? urls : NULL,
+          asset_urls && *asset_urls ? asset_urls : NULL)) {
+    if (error)
+      *error = g_strdup ("invalid endpoint list");
+    return false;
+  }
+
+  return true;
+}
+
+static bool
+endpoints_cb (MeloSettings *settings, MeloSettingsGroup *group, char **error,
+    void *user_data)
+{
+  return melo_radio_net_set_endpoints (error);
+}
+
+static bool
+melo_radio_net_set_budget (char **error)
+{
+  uint32_t budget = 0;
+
+  /* Get memory budget, in KiB */
+  melo_settings_entry_get_uint32 (entry_budget, &budget, NULL);
+
+  /* Apply memory budget */
+  if (!melo_radio_net_browser_set_memory_budget (
+          browser, (size_t) budget * 1024)) {
+    if (error)
+      *error = g_strdup ("invalid memory budget");
+    return false;
+  }
+
+  return true;
+}
+
+static bool
+memory_cb (MeloSettings *settings, MeloSettingsGroup *group, char **error,
+    void *user_data)
+{
+  return melo_radio_net_set_budget (error);
+}
+
+static void
+melo_radio_net_settings_init (void)
+{
+  MeloSettingsGroup *group;
+
+  /* Create settings */
+  settings = melo_settings_new (MELO_RADIO_NET_ID);
+  if (!settings)
+    return;
+
+  /* Endpoints group */
+  group = melo_settings_add_group (settings, "endpoints", "Endpoints",
+      "Radio.net servers, such as a local mirror before the official ones",
+      endpoints_cb, NULL);
+  entry_urls = melo_settings_group_add_string (group, "urls", "API servers",
+      "Comma separated list of API base URLs, empty for default", "", NULL,
+      MELO_SETTINGS_FLAG_NONE);
+  entry_asset_urls = melo_settings_group_add_string (group, "asset_urls",
+      "Logo servers",
+      "Comma separated list of logo base URLs, empty for default", "", NULL,
+      MELO_SETTINGS_FLAG_NONE);
+
+  /* Memory group */
+  group = melo_settings_add_group (settings, "memory", "Memory",
+      "Memory used by the station and category caches", memory_cb, NULL);
+  entry_budget = melo_settings_group_add_uint32 (group, "budget",
+      "Memory budget", "Maximum memory used by caches, in KiB",
+      MELO_RADIO_NET_BROWSER_MEMORY_BUDGET / 1024, NULL,
+      MELO_SETTINGS_FLAG_NONE);
+
+  /* Load settings */
+  melo_settings_load (settings);
+}
+
 static void
 melo_radio_net_enable (void)
 {
   /* Create radio.net browser */
   browser = melo_radio_net_browser_new ();
+  if (!browser)
+    return;
+
+  /* Load settings and apply endpoints and memory budget */
+  melo_radio_net_settings_init ();
+  if (settings) {
+    melo_radio_net_set_endpoints (NULL);
+    melo_radio_net_set_budget (NULL);
+  }
 }
 
 static void
 melo_radio_net_disable (void)
 {
-  /* Release radio.net browser */
-  g_object_unref (browser);
+  /* Release settings */
+  if (settings)
+    g_object_unref (settings);
+  settings = NULL;
+
+  /* Stop background tasks and release radio.net browser */
+  if (browser) {
+    melo_radio_net_browser_stop (browser);
+    g_object_unref (browser);
+  }
+  browser = NULL;
 }
 
 static const char *melo_radio_net_browser_list[] = {
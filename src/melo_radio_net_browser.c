@@ -17,6 +17,8 @@
 
 #include <stdio.h>
 
+#include <gio/gio.h>
+
 #include <melo/melo_http_client.h>
 #include <melo/melo_library.h>
 #include <melo/melo_playlist.h>
@@ -27,104 +29,1778 @@
 #include <melo/proto/browser.pb-c.h>
 
 #include "melo_radio_net_browser.h"
+#include "melo_radio_net_endpoints.h"
+#include "melo_radio_net_prober.h"
+#include "melo_radio_net_store.h"
 
 #define RADIO_PLAYER_ID "com.sparod.radio.player"
 
-#define MELO_RADIO_NET_BROWSER_URL "https://prod.radio-api.net/"
-#define MELO_RADIO_NET_BROWSER_USER_AGENT "rad.io for Melo (Android API)"
-#define MELO_RADIO_NET_BROWSER_ASSET_URL \
-  "https://station-images.prod.radio-api.net/"
+#define MELO_RADIO_NET_BROWSER_URL "https://prod.radio-api.net/"
+#define MELO_RADIO_NET_BROWSER_USER_AGENT "rad.io for Melo (Android API)"
+#define MELO_RADIO_NET_BROWSER_ASSET_URL \
+  "https://station-images.prod.radio-api.net/"
+
+#define MELO_RADIO_NET_BROWSER_MAX_WORKERS 2
+#define MELO_RADIO_NET_BROWSER_VISIBLE_MAX 2048
+#define MELO_RADIO_NET_BROWSER_VISIBLE_TTL 600
+#define MELO_RADIO_NET_BROWSER_PAGE_MAX 64
+#define MELO_RADIO_NET_BROWSER_PAGE_TTL 600
+#define MELO_RADIO_NET_BROWSER_HISTORY_MAX 256
+#define MELO_RADIO_NET_BROWSER_HISTORY_FILE "radio_net_history"
+#define MELO_RADIO_NET_BROWSER_WARM_LISTS 5
+#define MELO_RADIO_NET_BROWSER_WARM_PERIOD 5
+#define MELO_RADIO_NET_BROWSER_WARM_IDLE 10
+#define MELO_RADIO_NET_BROWSER_WARM_RETRY 600
+#define MELO_RADIO_NET_BROWSER_STREAM_TTL 3600
+#define MELO_RADIO_NET_BROWSER_CHECK_PERIOD 60
+#define MELO_RADIO_NET_BROWSER_CHECK_INTERVAL 21600
+#define MELO_RADIO_NET_BROWSER_CHECK_BATCH 10
+#define MELO_RADIO_NET_BROWSER_FAVORITE_PAGE 100
+#define MELO_RADIO_NET_BROWSER_MEMORY_PERIOD 300
+#define MELO_RADIO_NET_BROWSER_WARM_SUSPEND 900
+#define MELO_RADIO_NET_BROWSER_ENTRY_SIZE (4 * sizeof (gpointer) + 16)
+
+typedef struct {
+  MeloRadioNetBrowser *browser;
+  char *tag;
+  char *filter;
+  MeloRadioNetStoreSort sort;
+  char *url;
+  unsigned int offset;
+  unsigned int count;
+} MeloRadioNetBrowserAsync;
+
+typedef struct {
+  unsigned int *stations;
+  unsigned int count;
+  gint64 expire;
+} MeloRadioNetBrowserPage;
+
+typedef enum {
+  MELO_RADIO_NET_BROWSER_WARM_TAGS,
+  MELO_RADIO_NET_BROWSER_WARM_LIST,
+  MELO_RADIO_NET_BROWSER_WARM_DETAILS,
+} MeloRadioNetBrowserWarmType;
+
+typedef struct {
+  MeloRadioNetBrowser *browser;
+  MeloRadioNetBrowserWarmType type;
+  char *url;
+} MeloRadioNetBrowserWarm;
+
+typedef struct {
+  MeloRadioNetBrowser *browser;
+  char *id;
+  char *name;
+  char *cover;
+} MeloRadioNetBrowserProbe;
+
+typedef struct {
+  MeloRadioNetBrowser *browser;
+  unsigned int count;
+} MeloRadioNetBrowserFavorites;
+
+typedef struct {
+  MeloRadioNetBrowser *browser;
+  char *ids;
+} MeloRadioNetBrowserCheck;
+
+typedef struct {
+  MeloRadioNetBrowser *browser;
+  char *url;
+  unsigned int generation;
+  unsigned int endpoint;
+  guint64 failed;
+  gint64 start;
+  MeloHttpClientJsonCb cb;
+  void *user_data;
+} MeloRadioNetBrowserCall;
+
+typedef struct {
+  char *id;
+  char *name;
+  char *cover;
+} MeloRadioNetBrowserItem;
+
+typedef struct {
+  MeloRadioNetBrowser *browser;
+  MeloRequest *req;
+  MeloRadioNetBrowserWarm *warm;
+  JsonNode *node;
+  unsigned int *stations;
+  unsigned int count;
+  MeloRadioNetBrowserItem *items;
+  unsigned int n_items;
+  MeloMessage *msg;
+} MeloRadioNetBrowserJob;
+
+struct _MeloRadioNetBrowser {
+  GObject parent_instance;
+
+  MeloHttpClient *client;
+  GThreadPool *pool;
+  bool cover_checked;
+  char *cover_prefix;
+
+  GHashTable *pages;
+  GHashTable *history;
+  bool history_changed;
+
+  bool stopped;
+  guint warm_id;
+  bool warming;
+  GHashTable *warm_tries;
+  gint64 warm_suspend;
+  guint check_id;
+  unsigned int checking;
+  MeloRadioNetProber *prober;
+
+  size_t budget;
+  guint memory_id;
+  unsigned int jobs;
+  size_t trim_target;
+#if GLIB_CHECK_VERSION(2, 64, 0)
+  GMemoryMonitor *monitor;
+#endif
+  unsigned int pending;
+  gint64 last_request;
+
+  /* Station store: taken before other locks when needed */
+  GMutex store_lock;
+  MeloRadioNetStore *store;
+
+  GMutex endpoints_lock;
+  MeloRadioNetEndpoints *endpoints;
+  MeloRadioNetEndpoints *asset_endpoints;
+  unsigned int generation;
+
+  GMutex lock;
+  GHashTable *visible;
+  GHashTable *favorites;
+};
+
+MELO_DEFINE_BROWSER (MeloRadioNetBrowser, melo_radio_net_browser)
+
+/* Station action IDs, depending on favorite state */
+static uint32_t set_fav_actions[] = {0, 1, 2};
+static uint32_t unset_fav_actions[] = {0, 1, 3};
+
+static bool melo_radio_net_browser_handle_request (
+    MeloBrowser *browser, const MeloMessage *msg, MeloRequest *req);
+static char *melo_radio_net_browser_get_asset (
+    MeloBrowser *browser, const char *id);
+static void melo_radio_net_browser_worker (gpointer data, gpointer user_data);
+static gboolean melo_radio_net_browser_warm (gpointer user_data);
+static gboolean melo_radio_net_browser_check (gpointer user_data);
+static void melo_radio_net_browser_check_memory (MeloRadioNetBrowser *browser);
+static gboolean melo_radio_net_browser_report_memory (gpointer user_data);
+#if GLIB_CHECK_VERSION(2, 64, 0)
+static void low_memory_cb (GMemoryMonitor *monitor,
+    GMemoryMonitorWarningLevel level, gpointer user_data);
+#endif
+static bool melo_radio_net_browser_call (MeloRadioNetBrowserCall *call);
+static bool melo_radio_net_browser_push_warm (
+    MeloRadioNetBrowserWarm *warm, JsonNode *node);
+static void melo_radio_net_browser_load_favorites (
+    MeloRadioNetBrowser *browser);
+static void melo_radio_net_browser_load_history (MeloRadioNetBrowser *browser);
+static void melo_radio_net_browser_save_history (MeloRadioNetBrowser *browser);
+
+static void
+melo_radio_net_browser_page_free (gpointer data)
+{
+  MeloRadioNetBrowserPage *page = data;
+
+  free (page->stations);
+  free (page);
+}
+
+static void
+melo_radio_net_browser_finalize (GObject *object)
+{
+  MeloRadioNetBrowser *browser = MELO_RADIO_NET_BROWSER (object);
+
+  /* Stop background tasks */
+  melo_radio_net_browser_stop (browser);
+
+  /* Wait for pending jobs and release worker pool */
+  g_thread_pool_free (browser->pool, FALSE, TRUE);
+
+  /* Release cover prefix */
+  g_free (browser->cover_prefix);
+
+  /* Release HTTP client and endpoints */
+  g_object_unref (browser->client);
+  melo_radio_net_endpoints_free (browser->endpoints);
+  melo_radio_net_endpoints_free (browser->asset_endpoints);
+  g_mutex_clear (&browser->endpoints_lock);
+
+  /* Release caches */
+  g_hash_table_unref (browser->pages);
+  g_hash_table_unref (browser->history);
+  g_hash_table_unref (browser->warm_tries);
+
+  /* Release station store */
+  melo_radio_net_store_free (browser->store);
+  g_mutex_clear (&browser->store_lock);
+
+  /* Release station lists */
+  g_hash_table_unref (browser->visible);
+  g_hash_table_unref (browser->favorites);
+  g_mutex_clear (&browser->lock);
+
+  /* Chain finalize */
+  G_OBJECT_CLASS (melo_radio_net_browser_parent_class)->finalize (object);
+}
+
+static void
+melo_radio_net_browser_class_init (MeloRadioNetBrowserClass *klass)
+{
+  MeloBrowserClass *parent_class = MELO_BROWSER_CLASS (klass);
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  /* Setup callbacks */
+  parent_class->handle_request = melo_radio_net_browser_handle_request;
+  parent_class->get_asset = melo_radio_net_browser_get_asset;
+
+  /* Set finalize */
+  object_class->finalize = melo_radio_net_browser_finalize;
+}
+
+static void
+melo_radio_net_browser_init (MeloRadioNetBrowser *self)
+{
+  /* Init station store */
+  g_mutex_init (&self->store_lock);
+  self->store = melo_radio_net_store_new ();
+
+  /* Init station lists */
+  g_mutex_init (&self->lock);
+  self->visible = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  self->favorites =
+      g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  /* Load favorite stations from library for checker and cache warmer */
+  melo_radio_net_browser_load_favorites (self);
+
+  /* Init page cache and request history */
+  self->pages = g_hash_table_new_full (
+      g_str_hash, g_str_equal, g_free, melo_radio_net_browser_page_free);
+  self->history = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  melo_radio_net_browser_load_history (self);
+  self->warm_tries =
+      g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  /* Create new HTTP client with default endpoints */
+  self->client = melo_http_client_new (MELO_RADIO_NET_BROWSER_USER_AGENT);
+  g_mutex_init (&self->endpoints_lock);
+  self->endpoints = melo_radio_net_endpoints_new (MELO_RADIO_NET_BROWSER_URL);
+  self->asset_endpoints =
+      melo_radio_net_endpoints_new (MELO_RADIO_NET_BROWSER_ASSET_URL);
+
+  /* Create worker pool for response generation */
+  self->pool = g_thread_pool_new (melo_radio_net_browser_worker, self,
+      MELO_RADIO_NET_BROWSER_MAX_WORKERS, FALSE, NULL);
+
+  /* Start cache warmer */
+  self->warm_id = g_timeout_add_seconds_full (G_PRIORITY_LOW,
+      MELO_RADIO_NET_BROWSER_WARM_PERIOD, melo_radio_net_browser_warm, self,
+      NULL);
+
+  /* Set memory budget and watch low memory warnings */
+  self->budget = MELO_RADIO_NET_BROWSER_MEMORY_BUDGET;
+  self->trim_target = G_MAXSIZE;
+  self->memory_id = g_timeout_add_seconds_full (G_PRIORITY_LOW,
+      MELO_RADIO_NET_BROWSER_MEMORY_PERIOD,
+      melo_radio_net_browser_report_memory, self, NULL);
+#if GLIB_CHECK_VERSION(2, 64, 0)
+  self->monitor = g_memory_monitor_dup_default ();
+  if (self->monitor)
+    g_signal_connect (self->monitor, "low-memory-warning",
+        G_CALLBACK (low_memory_cb), self);
+#endif
+
+  /* Start favorite stream checker */
+  self->prober = melo_radio_net_prober_new (MELO_RADIO_NET_BROWSER_USER_AGENT);
+  self->check_id = g_timeout_add_seconds_full (G_PRIORITY_LOW,
+      MELO_RADIO_NET_BROWSER_CHECK_PERIOD, melo_radio_net_browser_check, self,
+      NULL);
+}
+
+MeloRadioNetBrowser *
+melo_radio_net_browser_new ()
+{
+  return g_object_new (MELO_TYPE_RADIO_NET_BROWSER, "id",
+      MELO_RADIO_NET_BROWSER_ID, "name", "Radio.net", "description",
+      "Browse in Radio.net directory", "icon", MELO_RADIO_NET_BROWSER_ICON,
+      "support-search", true, NULL);
+}
+
+void
+melo_radio_net_browser_stop (MeloRadioNetBrowser *browser)
+{
+  if (browser->stopped)
+    return;
+  browser->stopped = true;
+
+  /* Stop cache warmer */
+  g_source_remove (browser->warm_id);
+  browser->warm_id = 0;
+
+  /* Stop favorite checker and cancel pending probes */
+  g_source_remove (browser->check_id);
+  browser->check_id = 0;
+  melo_radio_net_prober_free (browser->prober);
+  browser->prober = NULL;
+
+  /* Stop memory report */
+  g_source_remove (browser->memory_id);
+  browser->memory_id = 0;
+
+  /* Save request history for next start */
+  melo_radio_net_browser_save_history (browser);
+
+#if GLIB_CHECK_VERSION(2, 64, 0)
+  /* Release memory monitor */
+  if (browser->monitor) {
+    g_signal_handlers_disconnect_by_data (browser->monitor, browser);
+    g_object_unref (browser->monitor);
+    browser->monitor = NULL;
+  }
+#endif
+}
+
+bool
+melo_radio_net_browser_set_endpoints (
+    MeloRadioNetBrowser *browser, const char *urls, const char *asset_urls)
+{
+  MeloRadioNetEndpoints *endpoints = NULL, *asset_endpoints = NULL;
+  MeloRadioNetEndpoints *old, *old_assets;
+
+  /* Parse endpoint lists */
+  endpoints = melo_radio_net_endpoints_new (
+      urls ? urls : MELO_RADIO_NET_BROWSER_URL);
+  asset_endpoints = melo_radio_net_endpoints_new (
+      asset_urls ? asset_urls : MELO_RADIO_NET_BROWSER_ASSET_URL);
+  if (!endpoints || !asset_endpoints) {
+    MELO_LOGE ("invalid endpoint list");
+    melo_radio_net_endpoints_free (endpoints);
+    melo_radio_net_endpoints_free (asset_endpoints);
+    return false;
+  }
+
+  /* Replace endpoint lists: pending calls don't report to the new ones */
+  g_mutex_lock (&browser->endpoints_lock);
+  old = browser->endpoints;
+  old_assets = browser->asset_endpoints;
+  browser->endpoints = endpoints;
+  browser->asset_endpoints = asset_endpoints;
+  browser->generation++;
+  g_mutex_unlock (&browser->endpoints_lock);
+
+  /* Release old endpoint lists */
+  melo_radio_net_endpoints_free (old);
+  melo_radio_net_endpoints_free (old_assets);
+
+  return true;
+}
+
+static void
+call_cb (MeloHttpClient *client, JsonNode *node, void *user_data)
+{
+  MeloRadioNetBrowserCall *call = user_data;
+  MeloRadioNetBrowser *browser = call->browser;
+
+  /* Request failed: retry on other endpoints */
+  if (!node) {
+    call->failed |= (guint64) 1 << call->endpoint;
+    if (melo_radio_net_browser_call (call))
+      return;
+  }
+
+  /* Update endpoint health, unless endpoint list has been replaced */
+  g_mutex_lock (&browser->endpoints_lock);
+  if (node && call->generation == browser->generation) {
+    unsigned int i;
+
+    melo_radio_net_endpoints_report (browser->endpoints, call->endpoint, true,
+        g_get_monotonic_time () - call->start);
+
+    /* Another endpoint answered: previous failures are not request errors */
+    for (i = 0; i < MELO_RADIO_NET_ENDPOINTS_MAX; i++)
+      if (call->failed & ((guint64) 1 << i))
+        melo_radio_net_endpoints_report (browser->endpoints, i, false, 0);
+  }
+  g_mutex_unlock (&browser->endpoints_lock);
+
+  /* Forward response */
+  call->cb (client, node, call->user_data);
+
+  /* Free call */
+  g_free (call->url);
+  free (call);
+}
+
+static bool
+melo_radio_net_browser_call (MeloRadioNetBrowserCall *call)
+{
+  MeloRadioNetBrowser *browser = call->browser;
+  unsigned int endpoint;
+  char *url;
+  bool ret;
+
+  g_mutex_lock (&browser->endpoints_lock);
+
+  /* Select fastest healthy endpoint not tried yet */
+  if (call->generation != browser->generation)
+    call->failed = 0;
+  endpoint =
+      melo_radio_net_endpoints_select (browser->endpoints, call->failed);
+  if (endpoint == MELO_RADIO_NET_ENDPOINTS_INVALID) {
+    g_mutex_unlock (&browser->endpoints_lock);
+    return false;
+  }
+
+  /* Generate full URL */
+  url = g_strconcat (
+      melo_radio_net_endpoints_get_url (browser->endpoints, endpoint),
+      call->url, NULL);
+  call->generation = browser->generation;
+
+  g_mutex_unlock (&browser->endpoints_lock);
+
+  MELO_LOGD ("get: %s", url);
+
+  /* Send request */
+  call->endpoint = endpoint;
+  call->start = g_get_monotonic_time ();
+  ret = melo_http_client_get_json (browser->client, url, call_cb, call);
+  g_free (url);
+
+  return ret;
+}
+
+static bool
+melo_radio_net_browser_get_json (MeloRadioNetBrowser *browser,
+    const char *url, MeloHttpClientJsonCb cb, void *user_data)
+{
+  MeloRadioNetBrowserCall *call;
+
+  /* Allocate call */
+  call = malloc (sizeof (*call));
+  if (!call)
+    return false;
+
+  /* Set call */
+  call->browser = browser;
+  call->url = g_strdup (url);
+  call->generation = 0;
+  call->failed = 0;
+  call->cb = cb;
+  call->user_data = user_data;
+
+  /* Send request to an endpoint */
+  if (!melo_radio_net_browser_call (call)) {
+    g_free (call->url);
+    free (call);
+    return false;
+  }
+
+  return true;
+}
+
+static const char *
+melo_radio_net_browser_get_cover (
+    MeloRadioNetBrowser *browser, JsonObject *obj)
+{
+  const char *logo, *cover = NULL;
+  unsigned int i, count;
+
+  /* Get biggest logo first */
+  if (json_object_has_member (obj, "logo300x300"))
+    logo = json_object_get_string_member (obj, "logo300x300");
+  else if (json_object_has_member (obj, "logo175x175"))
+    logo = json_object_get_string_member (obj, "logo175x175");
+  else if (json_object_has_member (obj, "logo100x100"))
+    logo = json_object_get_string_member (obj, "logo100x100");
+  else if (json_object_has_member (obj, "logo44x44"))
+    logo = json_object_get_string_member (obj, "logo44x44");
+  else
+    return NULL;
+
+  /* Remove prefix of any asset endpoint */
+  g_mutex_lock (&browser->endpoints_lock);
+  count = melo_radio_net_endpoints_get_count (browser->asset_endpoints);
+  for (i = 0; i < count && !cover; i++) {
+    const char *prefix =
+        melo_radio_net_endpoints_get_url (browser->asset_endpoints, i);
+
+    if (g_str_has_prefix (logo, prefix))
+      cover = logo + strlen (prefix);
+  }
+  g_mutex_unlock (&browser->endpoints_lock);
+
+  return cover;
+}
+
+static unsigned int
+melo_radio_net_browser_load_station (
+    MeloRadioNetBrowser *browser, JsonObject *obj)
+{
+  const char *id, *known, *stream = NULL;
+
+  /* Get last known good stream URL */
+  id = json_object_get_string_member (obj, "id");
+  known = melo_radio_net_store_get_station_stream (
+      browser->store, melo_radio_net_store_find_station (browser->store, id));
+
+  /* Get first stream URL, or the last known good one if still listed */
+  if (json_object_has_member (obj, "streams")) {
+    JsonArray *urls;
+    unsigned int i, count;
+
+    urls = json_object_get_array_member (obj, "streams");
+    count = urls ? json_array_get_length (urls) : 0;
+    for (i = 0; i < count; i++) {
+      const char *url;
+      JsonObject *o;
+
+      /* Get next object */
+      o = json_array_get_object_element (urls, i);
+      if (!o || !json_object_has_member (o, "url"))
+        continue;
+
+      /* Get URL */
+      url = json_object_get_string_member (o, "url");
+      if (!stream)
+        stream = url;
+      if (known && !g_strcmp0 (url, known)) {
+        stream = known;
+        break;
+      }
+    }
+  }
+
+  /* Add station to store */
+  return melo_radio_net_store_add_station (browser->store, id,
+      json_object_get_string_member (obj, "name"),
+      melo_radio_net_browser_get_cover (browser, obj), stream);
+}
+
+static unsigned int *
+melo_radio_net_browser_load_stations (
+    MeloRadioNetBrowser *browser, JsonObject *obj, unsigned int *count)
+{
+  unsigned int *stations;
+  JsonArray *array;
+  unsigned int i, len;
+
+  *count = 0;
+
+  /* Check stations are available */
+  if (!obj || !json_object_has_member (obj, "playables"))
+    return NULL;
+
+  /* Get stations */
+  array = json_object_get_array_member (obj, "playables");
+  if (!array || json_array_get_length (array) < 1)
+    return NULL;
+
+  /* Allocate station handles */
+  len = json_array_get_length (array);
+  stations = malloc (sizeof (*stations) * len);
+  if (!stations)
+    return NULL;
+
+  /* Add stations to store */
+  for (i = 0; i < len; i++) {
+    JsonObject *o = json_array_get_object_element (array, i);
+    unsigned int handle;
+
+    if (!o)
+      continue;
+
+    handle = melo_radio_net_browser_load_station (browser, o);
+    if (handle != MELO_RADIO_NET_STORE_INVALID)
+      stations[(*count)++] = handle;
+  }
+
+  return stations;
+}
+
+static void
+melo_radio_net_browser_load_tags (MeloRadioNetBrowser *browser, JsonObject *obj)
+{
+  MeloRadioNetStoreCategory category;
+
+  if (!obj)
+    return;
+
+  /* Replace tag catalogue */
+  melo_radio_net_store_clear_tags (browser->store);
+
+  /* Add tags of each category */
+  for (category = 0; category < MELO_RADIO_NET_STORE_CATEGORY_COUNT;
+       category++) {
+    const char *name = melo_radio_net_store_get_category_name (category);
+    JsonArray *array;
+    unsigned int i, len;
+
+    /* Get category */
+    if (!json_object_has_member (obj, name))
+      continue;
+    array = json_object_get_array_member (obj, name);
+    if (!array)
+      continue;
+
+    /* Add tags */
+    len = json_array_get_length (array);
+    for (i = 0; i < len; i++) {
+      JsonObject *o = json_array_get_object_element (array, i);
+      unsigned int stations = 0;
+
+      if (!o)
+        continue;
+
+      /* Get station count */
+      if (json_object_has_member (o, "count"))
+        stations = json_object_get_int_member (o, "count");
+
+      melo_radio_net_store_add_tag (browser->store, category,
+          json_object_get_string_member (o, "systemName"),
+          json_object_get_string_member (o, "name"), stations);
+    }
+  }
+
+  /* Build sorted indexes for filtering and sorting */
+  melo_radio_net_store_index_tags (browser->store);
+}
+
+static MeloRadioNetBrowserPage *
+melo_radio_net_browser_get_page (MeloRadioNetBrowser *browser, const char *url)
+{
+  MeloRadioNetBrowserPage *page;
+
+  /* Find page */
+  page = g_hash_table_lookup (browser->pages, url);
+  if (!page)
+    return NULL;
+
+  /* Page expired */
+  if (page->expire < g_get_monotonic_time ()) {
+    g_hash_table_remove (browser->pages, url);
+    return NULL;
+  }
+
+  return page;
+}
+
+static void
+melo_radio_net_browser_put_page (MeloRadioNetBrowser *browser,
+    const char *url, const unsigned int *stations, unsigned int count)
+{
+  MeloRadioNetBrowserPage *page;
+
+  /* Cache is full: drop the page expiring first */
+  if (!g_hash_table_contains (browser->pages, url) &&
+      g_hash_table_size (browser->pages) >= MELO_RADIO_NET_BROWSER_PAGE_MAX) {
+    MeloRadioNetBrowserPage *p, *oldest = NULL;
+    const char *u, *oldest_url = NULL;
+    GHashTableIter iter;
+
+    g_hash_table_iter_init (&iter, browser->pages);
+    while (g_hash_table_iter_next (&iter, (gpointer *) &u, (gpointer *) &p)) {
+      if (!oldest || p->expire < oldest->expire) {
+        oldest = p;
+        oldest_url = u;
+      }
+    }
+    if (oldest_url)
+      g_hash_table_remove (browser->pages, oldest_url);
+  }
+
+  /* Allocate page */
+  page = malloc (sizeof (*page));
+  if (!page)
+    return;
+
+  /* Copy station handles */
+  page->stations = malloc (sizeof (*page->stations) * count);
+  if (!page->stations) {
+    free (page);
+    return;
+  }
+  memcpy (page->stations, stations, sizeof (*page->stations) * count);
+  page->count = count;
+
+  /* Add page to cache */
+  page->expire = g_get_monotonic_time () +
+                 MELO_RADIO_NET_BROWSER_PAGE_TTL * G_USEC_PER_SEC;
+  g_hash_table_replace (browser->pages, g_strdup (url), page);
+}
+
+static gboolean
+history_age_cb (gpointer key, gpointer value, gpointer user_data)
+{
+  return GPOINTER_TO_UINT (value) < 2;
+}
+
+static void
+melo_radio_net_browser_add_history (
+    MeloRadioNetBrowser *browser, const char *url)
+{
+  guint hits = GPOINTER_TO_UINT (g_hash_table_lookup (browser->history, url));
+
+  /* History is full: halve all counters and drop the rarely used lists */
+  if (!hits &&
+      g_hash_table_size (browser->history) >= MELO_RADIO_NET_BROWSER_HISTORY_MAX) {
+    GHashTableIter iter;
+    gpointer value;
+
+    g_hash_table_foreach_remove (browser->history, history_age_cb, NULL);
+    g_hash_table_iter_init (&iter, browser->history);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+      g_hash_table_iter_replace (
+          &iter, GUINT_TO_POINTER (GPOINTER_TO_UINT (value) / 2));
+  }
+
+  /* Count list request */
+  g_hash_table_replace (
+      browser->history, g_strdup (url), GUINT_TO_POINTER (hits + 1));
+  browser->history_changed = true;
+}
+
+static char *
+melo_radio_net_browser_get_history_path (void)
+{
+  return g_build_filename (g_get_user_cache_dir (), "melo",
+      MELO_RADIO_NET_BROWSER_HISTORY_FILE, NULL);
+}
+
+static void
+melo_radio_net_browser_load_history (MeloRadioNetBrowser *browser)
+{
+  char *path, *data, **lines;
+  unsigned int i;
+
+  /* Read history file */
+  path = melo_radio_net_browser_get_history_path ();
+  if (!g_file_get_contents (path, &data, NULL, NULL)) {
+    g_free (path);
+    return;
+  }
+  g_free (path);
+
+  /* Parse lines: "<hits> <url>" */
+  lines = g_strsplit (data, "\n", -1);
+  for (i = 0; lines[i] && i < MELO_RADIO_NET_BROWSER_HISTORY_MAX; i++) {
+    char *url;
+    guint64 hits;
+
+    hits = g_ascii_strtoull (lines[i], &url, 10);
+    if (!hits || *url != ' ' || !g_str_has_prefix (url + 1, "stations/"))
+      continue;
+
+    g_hash_table_replace (browser->history, g_strdup (url + 1),
+        GUINT_TO_POINTER (MIN (hits, G_MAXUINT)));
+  }
+  g_strfreev (lines);
+  g_free (data);
+
+  MELO_LOGD ("%u lists loaded from history",
+      g_hash_table_size (browser->history));
+}
+
+static void
+melo_radio_net_browser_save_history (MeloRadioNetBrowser *browser)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+  GError *error = NULL;
+  char *path, *dir;
+  GString *data;
+
+  if (!browser->history_changed)
+    return;
+  browser->history_changed = false;
+
+  /* Generate history: "<hits> <url>" per line */
+  data = g_string_new (NULL);
+  g_hash_table_iter_init (&iter, browser->history);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    g_string_append_printf (
+        data, "%u %s\n", GPOINTER_TO_UINT (value), (const char *) key);
+
+  /* Write history file */
+  path = melo_radio_net_browser_get_history_path ();
+  dir = g_path_get_dirname (path);
+  g_mkdir_with_parents (dir, 0755);
+  if (!g_file_set_contents (path, data->str, data->len, &error)) {
+    MELO_LOGW ("failed to save history: %s", error->message);
+    g_error_free (error);
+  }
+  g_string_free (data, TRUE);
+  g_free (path);
+  g_free (dir);
+}
+
+static void
+melo_radio_net_browser_set_favorite (
+    MeloRadioNetBrowser *browser, const char *id, bool favorite)
+{
+  if (!id)
+    return;
+
+  /* Favorite list holds the last stream check time */
+  g_mutex_lock (&browser->lock);
+  if (favorite) {
+    if (!g_hash_table_contains (browser->favorites, id))
+      g_hash_table_insert (browser->favorites, g_strdup (id), NULL);
+  } else
+    g_hash_table_remove (browser->favorites, id);
+  g_mutex_unlock (&browser->lock);
+}
+
+static bool
+favorite_cb (const MeloLibraryData *data, MeloTags *tags, void *user_data)
+{
+  MeloRadioNetBrowserFavorites *favs = user_data;
+
+  /* Count entries for next page */
+  favs->count++;
+
+  /* Add radio.net stations only */
+  if (tags &&
+      !g_strcmp0 (melo_tags_get_browser (tags), MELO_RADIO_NET_BROWSER_ID))
+    melo_radio_net_browser_set_favorite (
+        favs->browser, melo_tags_get_media_id (tags), true);
+
+  return true;
+}
+
+static void
+melo_radio_net_browser_load_favorites (MeloRadioNetBrowser *browser)
+{
+  MeloRadioNetBrowserFavorites favs = {browser, 0};
+  off_t offset = 0;
+
+  /* Find all favorites, page by page */
+  do {
+    favs.count = 0;
+    melo_library_find (MELO_LIBRARY_TYPE_MEDIA, favorite_cb, &favs,
+        MELO_LIBRARY_SELECT (BROWSER) | MELO_LIBRARY_SELECT (MEDIA_ID),
+        MELO_RADIO_NET_BROWSER_FAVORITE_PAGE, offset, MELO_LIBRARY_FIELD_NONE,
+        false, false, MELO_LIBRARY_FIELD_FLAGS, MELO_LIBRARY_FLAG_FAVORITE,
+        MELO_LIBRARY_FIELD_LAST);
+    offset += favs.count;
+  } while (favs.count == MELO_RADIO_NET_BROWSER_FAVORITE_PAGE);
+
+  MELO_LOGD ("%u favorite stations loaded",
+      g_hash_table_size (browser->favorites));
+}
+
+void
+melo_radio_net_browser_get_memory (
+    MeloRadioNetBrowser *browser, MeloRadioNetBrowserMemory *mem)
+{
+  MeloRadioNetBrowserPage *page;
+  GHashTableIter iter;
+  const char *url;
+  size_t size;
+
+  /* Page cache */
+  mem->budget = browser->budget;
+  mem->pages = 0;
+  g_hash_table_iter_init (&iter, browser->pages);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &url, (gpointer *) &page))
+    mem->pages += MELO_RADIO_NET_BROWSER_ENTRY_SIZE + strlen (url) + 1 +
+                  sizeof (*page) + page->count * sizeof (*page->stations);
+
+  /* Station store */
+  g_mutex_lock (&browser->store_lock);
+  size = melo_radio_net_store_get_size (browser->store);
+  mem->tags = melo_radio_net_store_get_tags_size (browser->store);
+  mem->stations = size > mem->tags ? size - mem->tags : 0;
+  g_mutex_unlock (&browser->store_lock);
+
+  /* Request history, displayed and favorite station lists */
+  g_mutex_lock (&browser->lock);
+  mem->lists = (g_hash_table_size (browser->history) +
+                   g_hash_table_size (browser->warm_tries) +
+                   g_hash_table_size (browser->visible) +
+                   g_hash_table_size (browser->favorites)) *
+               MELO_RADIO_NET_BROWSER_ENTRY_SIZE;
+  g_mutex_unlock (&browser->lock);
+}
+
+static size_t
+melo_radio_net_browser_memory_total (const MeloRadioNetBrowserMemory *mem)
+{
+  return mem->pages + mem->stations + mem->tags + mem->lists;
+}
+
+static void
+melo_radio_net_browser_log_memory (
+    MeloRadioNetBrowser *browser, const char *when)
+{
+  MeloRadioNetBrowserMemory mem;
+
+  melo_radio_net_browser_get_memory (browser, &mem);
+  MELO_LOGI ("memory %s: pages=%zu stations=%zu tags=%zu lists=%zu "
+             "total=%zu budget=%zu",
+      when, mem.pages, mem.stations, mem.tags, mem.lists,
+      melo_radio_net_browser_memory_total (&mem), mem.budget);
+}
+
+static size_t
+melo_radio_net_browser_get_memory_total (MeloRadioNetBrowser *browser)
+{
+  MeloRadioNetBrowserMemory mem;
+
+  melo_radio_net_browser_get_memory (browser, &mem);
+  return melo_radio_net_browser_memory_total (&mem);
+}
+
+static void
+melo_radio_net_browser_compact (MeloRadioNetBrowser *browser)
+{
+  MeloRadioNetBrowserPage *page;
+  unsigned int *remap, i, count;
+  GHashTableIter iter;
+  gpointer key;
+  bool *keep;
+
+  g_mutex_lock (&browser->store_lock);
+
+  /* Allocate station maps */
+  count = melo_radio_net_store_get_station_count (browser->store);
+  keep = g_new0 (bool, count);
+  remap = g_new (unsigned int, count);
+
+  /* Keep stations of cached pages */
+  g_hash_table_iter_init (&iter, browser->pages);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &page))
+    for (i = 0; i < page->count; i++)
+      if (page->stations[i] < count)
+        keep[page->stations[i]] = true;
+
+  /* Keep favorite stations */
+  g_mutex_lock (&browser->lock);
+  g_hash_table_iter_init (&iter, browser->favorites);
+  while (g_hash_table_iter_next (&iter, &key, NULL)) {
+    i = melo_radio_net_store_find_station (browser->store, key);
+    if (i < count)
+      keep[i] = true;
+  }
+  g_mutex_unlock (&browser->lock);
+
+  /* Remove other stations */
+  melo_radio_net_store_compact (browser->store, keep, remap);
+
+  /* Update page handles */
+  g_hash_table_iter_init (&iter, browser->pages);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &page))
+    for (i = 0; i < page->count; i++)
+      if (page->stations[i] < count)
+        page->stations[i] = remap[page->stations[i]];
+
+  g_mutex_unlock (&browser->store_lock);
+
+  g_free (remap);
+  g_free (keep);
+}
+
+static gboolean
+page_expired_cb (gpointer key, gpointer value, gpointer user_data)
+{
+  MeloRadioNetBrowserPage *page = value;
+
+  return page->expire < *(gint64 *) user_data;
+}
+
+static void
+melo_radio_net_browser_drop_pages (MeloRadioNetBrowser *browser)
+{
+  gint64 *expire, median;
+  MeloRadioNetBrowserPage *page;
+  GHashTableIter iter;
+  unsigned int i = 0, count;
+
+  /* Get expiration times */
+  count = g_hash_table_size (browser->pages);
+  if (!count)
+    return;
+  expire = g_new (gint64, count);
+  g_hash_table_iter_init (&iter, browser->pages);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &page))
+    expire[i++] = page->expire;
+
+  /* Drop the oldest half */
+  for (i = 1; i < count; i++) {
+    gint64 e = expire[i];
+    unsigned int j = i;
+
+    while (j > 0 && expire[j - 1] > e) {
+      expire[j] = expire[j - 1];
+      j--;
+    }
+    expire[j] = e;
+  }
+  median = expire[count / 2] + 1;
+  g_hash_table_foreach_remove (browser->pages, page_expired_cb, &median);
+  g_free (expire);
+}
+
+static void
+melo_radio_net_browser_trim (MeloRadioNetBrowser *browser, size_t target)
+{
+  gint64 now = g_get_monotonic_time ();
+
+  /* Apply lowest target requested while trim was postponed */
+  target = MIN (target, browser->trim_target);
+  if (melo_radio_net_browser_get_memory_total (browser) <= target) {
+    browser->trim_target = G_MAXSIZE;
+    return;
+  }
+
+  /* Station handles are in use by the worker pool: postpone trim */
+  if (browser->jobs) {
+    browser->trim_target = target;
+    return;
+  }
+  browser->trim_target = G_MAXSIZE;
+
+  /* Suspend cache warmer, so it doesn't refill caches right away */
+  browser->warm_suspend =
+      now + MELO_RADIO_NET_BROWSER_WARM_SUSPEND * G_USEC_PER_SEC;
+
+  melo_radio_net_browser_log_memory (browser, "before trim");
+
+  /* Drop expired pages and stations not referenced anymore */
+  g_hash_table_foreach_remove (browser->pages, page_expired_cb, &now);
+  melo_radio_net_browser_compact (browser);
+
+  /* Drop oldest pages, which are cheap to fetch again */
+  while (melo_radio_net_browser_get_memory_total (browser) > target &&
+         g_hash_table_size (browser->pages)) {
+    melo_radio_net_browser_drop_pages (browser);
+    melo_radio_net_browser_compact (browser);
+  }
+
+  /* Drop tag catalogue, the most expensive to fetch again */
+  if (melo_radio_net_browser_get_memory_total (browser) > target) {
+    g_mutex_lock (&browser->store_lock);
+    melo_radio_net_store_clear_tags (browser->store);
+    g_mutex_unlock (&browser->store_lock);
+    melo_radio_net_browser_compact (browser);
+  }
+
+  melo_radio_net_browser_log_memory (browser, "after trim");
+}
+
+static void
+melo_radio_net_browser_check_memory (MeloRadioNetBrowser *browser)
+{
+  /* Trim down to 3/4 of budget to avoid trimming on each new entry */
+  if (browser->trim_target != G_MAXSIZE ||
+      melo_radio_net_browser_get_memory_total (browser) > browser->budget)
+    melo_radio_net_browser_trim (browser, browser->budget / 4 * 3);
+}
+
+static gboolean
+melo_radio_net_browser_report_memory (gpointer user_data)
+{
+  MeloRadioNetBrowser *browser = user_data;
+
+  /* Log memory usage for budget tuning */
+  melo_radio_net_browser_log_memory (browser, "usage");
+
+  /* Save request history */
+  melo_radio_net_browser_save_history (browser);
+
+  /* Enforce memory budget */
+  melo_radio_net_browser_check_memory (browser);
+
+  return G_SOURCE_CONTINUE;
+}
+
+bool
+melo_radio_net_browser_set_memory_budget (
+    MeloRadioNetBrowser *browser, size_t budget)
+{
+  if (!budget)
+    return false;
+
+  /* Set new budget */
+  browser->budget = budget;
+  melo_radio_net_browser_check_memory (browser);
+
+  return true;
+}
+
+#if GLIB_CHECK_VERSION(2, 64, 0)
+static void
+low_memory_cb (GMemoryMonitor *monitor, GMemoryMonitorWarningLevel level,
+    gpointer user_data)
+{
+  MeloRadioNetBrowser *browser = user_data;
+
+  MELO_LOGW ("low memory warning: %d", level);
+
+  /* Release half of the budget, or all caches if memory is critical */
+  melo_radio_net_browser_trim (browser,
+      level >= G_MEMORY_MONITOR_WARNING_LEVEL_MEDIUM ? 0 : browser->budget / 2);
+}
+#endif
+
+static void
+melo_radio_net_browser_warm_free (MeloRadioNetBrowserWarm *warm)
+{
+  MeloRadioNetBrowser *browser = warm->browser;
+
+  /* Free warm object */
+  browser->warming = false;
+  g_free (warm->url);
+  free (warm);
+
+  /* Enforce memory budget */
+  melo_radio_net_browser_check_memory (browser);
+  g_object_unref (browser);
+}
+
+static unsigned int *
+melo_radio_net_browser_load_warm (
+    MeloRadioNetBrowserWarm *warm, JsonNode *node, unsigned int *count)
+{
+  MeloRadioNetBrowser *browser = warm->browser;
+  unsigned int *stations = NULL;
+
+  *count = 0;
+
+  g_mutex_lock (&browser->store_lock);
+  if (warm->type == MELO_RADIO_NET_BROWSER_WARM_TAGS) {
+    /* Load tag catalogue */
+    if (!melo_radio_net_store_has_tags (browser->store))
+      melo_radio_net_browser_load_tags (browser, json_node_get_object (node));
+  } else if (warm->type == MELO_RADIO_NET_BROWSER_WARM_LIST) {
+    /* Load stations */
+    stations = melo_radio_net_browser_load_stations (
+        browser, json_node_get_object (node), count);
+  } else {
+    JsonArray *array = json_node_get_array (node);
+    unsigned int i, len;
+
+    /* Load station details */
+    len = array ? json_array_get_length (array) : 0;
+    for (i = 0; i < len; i++) {
+      JsonObject *o = json_array_get_object_element (array, i);
+      if (o)
+        melo_radio_net_browser_load_station (browser, o);
+    }
+  }
+  g_mutex_unlock (&browser->store_lock);
+
+  return stations;
+}
+
+static void
+warm_cb (MeloHttpClient *client, JsonNode *node, void *user_data)
+{
+  MeloRadioNetBrowserWarm *warm = user_data;
+
+  /* Load result in worker pool */
+  if (node && !warm->browser->stopped &&
+      melo_radio_net_browser_push_warm (warm, node))
+    return;
+
+  /* Free warm object */
+  melo_radio_net_browser_warm_free (warm);
+}
+
+static char *
+melo_radio_net_browser_next_warm (
+    MeloRadioNetBrowser *browser, MeloRadioNetBrowserWarmType *type)
+{
+  const char *top_url[MELO_RADIO_NET_BROWSER_WARM_LISTS] = {NULL};
+  guint top_hits[MELO_RADIO_NET_BROWSER_WARM_LISTS] = {0};
+  GHashTableIter iter;
+  gpointer key, value;
+  char *url = NULL;
+  unsigned int i;
+
+  /* Find most requested lists */
+  g_hash_table_iter_init (&iter, browser->history);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    guint hits = GPOINTER_TO_UINT (value);
+
+    for (i = 0; i < MELO_RADIO_NET_BROWSER_WARM_LISTS; i++) {
+      if (hits > top_hits[i]) {
+        memmove (&top_url[i + 1], &top_url[i],
+            sizeof (*top_url) * (MELO_RADIO_NET_BROWSER_WARM_LISTS - i - 1));
+        memmove (&top_hits[i + 1], &top_hits[i],
+            sizeof (*top_hits) * (MELO_RADIO_NET_BROWSER_WARM_LISTS - i - 1));
+        top_url[i] = key;
+        top_hits[i] = hits;
+        break;
+      }
+    }
+  }
+
+  /* First page of a frequent list, not tried recently */
+  *type = MELO_RADIO_NET_BROWSER_WARM_LIST;
+  for (i = 0; i < MELO_RADIO_NET_BROWSER_WARM_LISTS && top_url[i]; i++)
+    if (!melo_radio_net_browser_get_page (browser, top_url[i]) &&
+        !g_hash_table_contains (browser->warm_tries, top_url[i]))
+      return g_strdup (top_url[i]);
+
+  /* Details of a favorite station without recent stream URL */
+  *type = MELO_RADIO_NET_BROWSER_WARM_DETAILS;
+  g_mutex_lock (&browser->store_lock);
+  g_mutex_lock (&browser->lock);
+  g_hash_table_iter_init (&iter, browser->favorites);
+  while (!url && g_hash_table_iter_next (&iter, &key, NULL)) {
+    unsigned int handle;
+
+    handle = melo_radio_net_store_find_station (browser->store, key);
+    if (melo_radio_net_store_get_station_stream_age (browser->store, handle) <
+        MELO_RADIO_NET_BROWSER_STREAM_TTL)
+      continue;
+
+    /* Skip stations tried recently: removed or without stream */
+    url = g_strdup_printf (
+        "stations/details?stationIds=%s", (const char *) key);
+    if (g_hash_table_contains (browser->warm_tries, url)) {
+      g_free (url);
+      url = NULL;
+    }
+  }
+  g_mutex_unlock (&browser->lock);
+  g_mutex_unlock (&browser->store_lock);
+
+  return url;
+}
+
+static gboolean
+warm_expired_cb (gpointer key, gpointer value, gpointer user_data)
+{
+  return GPOINTER_TO_UINT (value) < GPOINTER_TO_UINT (user_data);
+}
+
+static gboolean
+melo_radio_net_browser_warm (gpointer user_data)
+{
+  MeloRadioNetBrowser *browser = user_data;
+  MeloRadioNetBrowserWarmType type = MELO_RADIO_NET_BROWSER_WARM_TAGS;
+  guint now = g_get_monotonic_time () / G_USEC_PER_SEC;
+  MeloRadioNetBrowserWarm *warm;
+  bool has_tags;
+  char *url = NULL;
+
+  /* Yield to interactive requests */
+  if (browser->warming || browser->pending ||
+      g_get_monotonic_time () - browser->last_request <
+          MELO_RADIO_NET_BROWSER_WARM_IDLE * G_USEC_PER_SEC)
+    return G_SOURCE_CONTINUE;
+
+  /* Caches have been trimmed recently or are close to the memory budget */
+  if (g_get_monotonic_time () < browser->warm_suspend ||
+      melo_radio_net_browser_get_memory_total (browser) >
+          browser->budget / 4 * 3)
+    return G_SOURCE_CONTINUE;
+
+  /* Forget old attempts */
+  if (now > MELO_RADIO_NET_BROWSER_WARM_RETRY)
+    g_hash_table_foreach_remove (browser->warm_tries, warm_expired_cb,
+        GUINT_TO_POINTER (now - MELO_RADIO_NET_BROWSER_WARM_RETRY));
+
+  /* Find next entry to warm: tag catalogue first, unless tried recently */
+  g_mutex_lock (&browser->store_lock);
+  has_tags = melo_radio_net_store_has_tags (browser->store);
+  g_mutex_unlock (&browser->store_lock);
+  if (has_tags ||
+      g_hash_table_contains (browser->warm_tries, "stations/tags")) {
+    url = melo_radio_net_browser_next_warm (browser, &type);
+    if (!url)
+      return G_SOURCE_CONTINUE;
+  }
+
+  /* Save attempt: failed or empty entries are not fetched again too soon */
+  g_hash_table_replace (browser->warm_tries,
+      g_strdup (url ? url : "stations/tags"), GUINT_TO_POINTER (now));
+
+  /* Allocate warm object */
+  warm = malloc (sizeof (*warm));
+  if (!warm) {
+    g_free (url);
+    return G_SOURCE_CONTINUE;
+  }
+  warm->browser = g_object_ref (browser);
+  warm->type = type;
+  warm->url = url;
+
+  MELO_LOGD ("warm: %s", url ? url : "tags");
+
+  /* Fetch a single entry */
+  browser->warming = melo_radio_net_browser_get_json (
+      browser, url ? url : "stations/tags", warm_cb, warm);
+  if (!browser->warming) {
+    g_object_unref (browser);
+    g_free (url);
+    free (warm);
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+melo_radio_net_browser_update_favorite (MeloRadioNetBrowser *browser,
+    const char *id, const char *name, const char *cover, const char *url)
+{
+  uint64_t old_id, new_id;
+  MeloTags *tags = NULL;
+  char *path, *media;
+
+  /* Get current favorite entry */
+  old_id =
+      melo_library_get_media_id_from_browser (MELO_RADIO_NET_BROWSER_ID, id);
+  if (!(melo_library_media_get_flags (old_id) & MELO_LIBRARY_FLAG_FAVORITE)) {
+    melo_radio_net_browser_set_favorite (browser, id, false);
+    return;
+  }
+
+  /* Separate path */
+  path = g_strdup (url);
+  media = strrchr (path, '/');
+  if (media)
+    *media++ = '\0';
+
+  /* Stream URL has changed: update favorite entry */
+  new_id = melo_library_get_media_id (RADIO_PLAYER_ID, 0, path, 0, media);
+  if (new_id != old_id) {
+    MELO_LOGI ("update favorite %s stream: %s", name, url);
+
+    /* Set tags */
+    tags = melo_tags_new ();
+    if (tags) {
+      if (cover)
+        melo_tags_set_cover (tags, G_OBJECT (browser), cover);
+      melo_tags_set_browser (tags, MELO_RADIO_NET_BROWSER_ID);
+      melo_tags_set_media_id (tags, (char *) id);
+    }
+
+    /* Replace stream of current entry: browser lookup keeps finding it */
+    if (!melo_library_add_media (RADIO_PLAYER_ID, 0, path, 0, media, old_id,
+            MELO_LIBRARY_SELECT (PATH) | MELO_LIBRARY_SELECT (MEDIA) |
+                MELO_LIBRARY_SELECT (COVER),
+            name, tags, 0, MELO_LIBRARY_FLAG_FAVORITE_ONLY))
+      MELO_LOGW ("failed to update favorite %s stream", name);
+    melo_tags_unref (tags);
+  }
+
+  g_free (path);
+}
+
+static void
+probe_cb (const char *url, void *user_data)
+{
+  MeloRadioNetBrowserProbe *probe = user_data;
+  MeloRadioNetBrowser *browser = probe->browser;
+
+  /* Probe done */
+  browser->checking--;
+
+  if (url) {
+    /* Save last known good stream URL */
+    g_mutex_lock (&browser->store_lock);
+    melo_radio_net_store_add_station (browser->store, probe->id, NULL, NULL, url);
+    g_mutex_unlock (&browser->store_lock);
+
+    /* Update library */
+    melo_radio_net_browser_update_favorite (
+        browser, probe->id, probe->name, probe->cover, url);
+
+    /* Enforce memory budget */
+    melo_radio_net_browser_check_memory (browser);
+  } else if (!browser->stopped)
+    MELO_LOGW ("no live stream for favorite %s", probe->name);
+
+  /* Free probe */
+  g_free (probe->id);
+  g_free (probe->name);
+  g_free (probe->cover);
+  free (probe);
+  g_object_unref (browser);
+}
+
+static void
+melo_radio_net_browser_check_station (
+    MeloRadioNetBrowser *browser, JsonObject *obj)
+{
+  MeloRadioNetBrowserProbe *probe;
+  const char *id, *known;
+  JsonArray *streams;
+  GPtrArray *urls;
+  unsigned int i, count;
+
+  /* Get station ID */
+  id = json_object_get_string_member (obj, "id");
+  if (!id)
+    return;
+
+  /* Allocate probe */
+  probe = malloc (sizeof (*probe));
+  if (!probe)
+    return;
+
+  g_mutex_lock (&browser->store_lock);
+
+  /* Probe last known good stream URL first */
+  urls = g_ptr_array_new ();
+  known = melo_radio_net_store_get_station_stream (
+      browser->store, melo_radio_net_store_find_station (browser->store, id));
+  if (known)
+    g_ptr_array_add (urls, (gpointer) known);
+
+  /* Then all current stream URLs */
+  streams = json_object_has_member (obj, "streams")
+                ? json_object_get_array_member (obj, "streams")
+                : NULL;
+  count = streams ? json_array_get_length (streams) : 0;
+  for (i = 0; i < count; i++) {
+    JsonObject *o = json_array_get_object_element (streams, i);
+    const char *url;
+
+    if (!o || !json_object_has_member (o, "url"))
+      continue;
+
+    url = json_object_get_string_member (o, "url");
+    if (url && g_strcmp0 (url, known))
+      g_ptr_array_add (urls, (gpointer) url);
+  }
+  g_ptr_array_add (urls, NULL);
+
+  /* Set probe */
+  probe->browser = g_object_ref (browser);
+  probe->id = g_strdup (id);
+  probe->name = g_strdup (json_object_get_string_member (obj, "name"));
+  probe->cover = g_strdup (melo_radio_net_browser_get_cover (browser, obj));
+
+  /* Find first live stream */
+  if (melo_radio_net_prober_check (browser->prober,
+          (const char *const *) urls->pdata, probe_cb, probe))
+    browser->checking++;
+  else {
+    g_object_unref (browser);
+    g_free (probe->id);
+    g_free (probe->name);
+    g_free (probe->cover);
+    free (probe);
+  }
+
+  g_mutex_unlock (&browser->store_lock);
+  g_ptr_array_free (urls, TRUE);
+}
+
+static void
+check_cb (MeloHttpClient *client, JsonNode *node, void *user_data)
+{
+  MeloRadioNetBrowserCheck *check = user_data;
+  MeloRadioNetBrowser *browser = check->browser;
+  JsonArray *array = NULL;
+  unsigned int i, len;
+
+  /* Save check time of stations batch: a failed batch is retried later */
+  if (node) {
+    guint now = g_get_monotonic_time () / G_USEC_PER_SEC;
+    char **ids = g_strsplit (check->ids, ",", -1);
+
+    g_mutex_lock (&browser->lock);
+    for (i = 0; ids[i]; i++)
+      if (g_hash_table_contains (browser->favorites, ids[i]))
+        g_hash_table_insert (
+            browser->favorites, g_strdup (ids[i]), GUINT_TO_POINTER (now));
+    g_mutex_unlock (&browser->lock);
+    g_strfreev (ids);
+  }
+
+  /* Probe streams of each station, unless browser is stopped */
+  if (node && !browser->stopped)
+    array = json_node_get_array (node);
+  len = array ? json_array_get_length (array) : 0;
+  for (i = 0; i < len; i++) {
+    JsonObject *obj = json_array_get_object_element (array, i);
+
+    if (obj)
+      melo_radio_net_browser_check_station (browser, obj);
+  }
+
+  /* Details request done */
+  browser->checking--;
+  g_free (check->ids);
+  free (check);
+  g_object_unref (browser);
+}
+
+static gboolean
+melo_radio_net_browser_check (gpointer user_data)
+{
+  MeloRadioNetBrowser *browser = user_data;
+  guint now = g_get_monotonic_time () / G_USEC_PER_SEC;
+  MeloRadioNetBrowserCheck *check;
+  unsigned int count = 0;
+  GHashTableIter iter;
+  gpointer key, value;
+  GString *ids;
+  char *url;
+
+  /* Yield to interactive requests and previous check */
+  if (browser->checking || browser->pending ||
+      g_get_monotonic_time () - browser->last_request <
+          MELO_RADIO_NET_BROWSER_WARM_IDLE * G_USEC_PER_SEC)
+    return G_SOURCE_CONTINUE;
+
+  /* Get favorites not checked recently */
+  ids = g_string_new (NULL);
+  g_mutex_lock (&browser->lock);
+  g_hash_table_iter_init (&iter, browser->favorites);
+  while (count < MELO_RADIO_NET_BROWSER_CHECK_BATCH &&
+         g_hash_table_iter_next (&iter, &key, &value)) {
+    guint last = GPOINTER_TO_UINT (value);
+
+    if (last && now - last < MELO_RADIO_NET_BROWSER_CHECK_INTERVAL)
+      continue;
 
-typedef struct {
-  MeloRadioNetBrowser *browser;
-  char *tag;
-  unsigned int offset;
-  unsigned int count;
-} MeloRadioNetBrowserAsync;
+    /* Add station to batch */
+    if (count++)
+      g_string_append_c (ids, ',');
+    g_string_append (ids, key);
+  }
+  g_mutex_unlock (&browser->lock);
 
-struct _MeloRadioNetBrowser {
-  GObject parent_instance;
+  /* Nothing to check */
+  if (!count) {
+    g_string_free (ids, TRUE);
+    return G_SOURCE_CONTINUE;
+  }
 
-  MeloHttpClient *client;
-  JsonNode *tags;
-};
+  /* Allocate check */
+  check = malloc (sizeof (*check));
+  if (!check) {
+    g_string_free (ids, TRUE);
+    return G_SOURCE_CONTINUE;
+  }
+  check->browser = g_object_ref (browser);
+  check->ids = g_string_free (ids, FALSE);
+
+  /* Get details of stations batch */
+  url = g_strdup_printf ("stations/details?stationIds=%s", check->ids);
+  browser->checking = 1;
+  if (!melo_radio_net_browser_get_json (browser, url, check_cb, check)) {
+    browser->checking = 0;
+    g_object_unref (browser);
+    g_free (check->ids);
+    free (check);
+  }
+  g_free (url);
 
-MELO_DEFINE_BROWSER (MeloRadioNetBrowser, melo_radio_net_browser)
+  return G_SOURCE_CONTINUE;
+}
 
-static bool melo_radio_net_browser_handle_request (
-    MeloBrowser *browser, const MeloMessage *msg, MeloRequest *req);
-static char *melo_radio_net_browser_get_asset (
-    MeloBrowser *browser, const char *id);
+static gboolean
+visible_expired_cb (gpointer key, gpointer value, gpointer user_data)
+{
+  return GPOINTER_TO_UINT (value) < GPOINTER_TO_UINT (user_data);
+}
 
 static void
-melo_radio_net_browser_finalize (GObject *object)
+melo_radio_net_browser_add_visible (
+    MeloRadioNetBrowser *browser, Browser__Response__MediaItem **items, size_t n)
 {
-  MeloRadioNetBrowser *browser = MELO_RADIO_NET_BROWSER (object);
+  guint now = g_get_monotonic_time () / G_USEC_PER_SEC;
+  size_t i;
+
+  g_mutex_lock (&browser->lock);
+
+  /* Drop stations not displayed recently */
+  if (g_hash_table_size (browser->visible) + n >
+      MELO_RADIO_NET_BROWSER_VISIBLE_MAX) {
+    if (now > MELO_RADIO_NET_BROWSER_VISIBLE_TTL)
+      g_hash_table_foreach_remove (browser->visible, visible_expired_cb,
+          GUINT_TO_POINTER (now - MELO_RADIO_NET_BROWSER_VISIBLE_TTL));
+    if (g_hash_table_size (browser->visible) + n >
+        MELO_RADIO_NET_BROWSER_VISIBLE_MAX)
+      g_hash_table_remove_all (browser->visible);
+  }
 
-  /* Release HTTP client */
-  g_object_unref (browser->client);
+  /* Save stations sent in list */
+  for (i = 0; i < n; i++)
+    if (items[i]->id)
+      g_hash_table_replace (
+          browser->visible, g_strdup (items[i]->id), GUINT_TO_POINTER (now));
 
-  /* Chain finalize */
-  G_OBJECT_CLASS (melo_radio_net_browser_parent_class)->finalize (object);
+  g_mutex_unlock (&browser->lock);
 }
 
 static void
-melo_radio_net_browser_class_init (MeloRadioNetBrowserClass *klass)
+melo_radio_net_browser_send_favorite (
+    MeloRadioNetBrowser *browser, const char *id, bool favorite)
 {
-  MeloBrowserClass *parent_class = MELO_BROWSER_CLASS (klass);
-  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  Browser__Event event = BROWSER__EVENT__INIT;
+  Browser__Response__MediaItem item;
+  MeloMessage *msg;
+  bool visible;
+
+  /* Only notify if station is displayed by a client */
+  g_mutex_lock (&browser->lock);
+  visible = id && g_hash_table_contains (browser->visible, id);
+  g_mutex_unlock (&browser->lock);
+  if (!visible)
+    return;
+
+  /* Set event type */
+  event.event_case = BROWSER__EVENT__EVENT_MEDIA_UPDATED;
+  event.media_updated = &item;
+
+  /* Set updated media: only favorite state and actions */
+  browser__response__media_item__init (&item);
+  item.id = (char *) id;
+  item.type = BROWSER__RESPONSE__MEDIA_ITEM__TYPE__MEDIA;
+  item.favorite = favorite;
+  if (favorite) {
+    item.n_action_ids = G_N_ELEMENTS (unset_fav_actions);
+    item.action_ids = unset_fav_actions;
+  } else {
+    item.n_action_ids = G_N_ELEMENTS (set_fav_actions);
+    item.action_ids = set_fav_actions;
+  }
 
-  /* Setup callbacks */
-  parent_class->handle_request = melo_radio_net_browser_handle_request;
-  parent_class->get_asset = melo_radio_net_browser_get_asset;
+  /* Pack event */
+  msg = melo_message_new (browser__event__get_packed_size (&event));
+  melo_message_set_size (
+      msg, browser__event__pack (&event, melo_message_get_data (msg)));
 
-  /* Set finalize */
-  object_class->finalize = melo_radio_net_browser_finalize;
+  /* Broadcast event */
+  melo_browser_send_event (MELO_BROWSER (browser), msg);
 }
 
 static void
-melo_radio_net_browser_init (MeloRadioNetBrowser *self)
+melo_radio_net_browser_items_free (
+    MeloRadioNetBrowserItem *items, unsigned int count)
 {
-  /* Create new HTTP client */
-  self->client = melo_http_client_new (MELO_RADIO_NET_BROWSER_USER_AGENT);
+  unsigned int i;
+
+  if (!items)
+    return;
+
+  for (i = 0; i < count; i++) {
+    g_free (items[i].id);
+    g_free (items[i].name);
+    g_free (items[i].cover);
+  }
+  free (items);
 }
 
-MeloRadioNetBrowser *
-melo_radio_net_browser_new ()
+static MeloRadioNetBrowserItem *
+melo_radio_net_browser_get_tag_items (MeloRadioNetBrowser *browser,
+    MeloRadioNetBrowserAsync *async, unsigned int *count)
 {
-  return g_object_new (MELO_TYPE_RADIO_NET_BROWSER, "id",
-      MELO_RADIO_NET_BROWSER_ID, "name", "Radio.net", "description",
-      "Browse in Radio.net directory", "icon", MELO_RADIO_NET_BROWSER_ICON,
-      "support-search", true, NULL);
-}
+  MeloRadioNetStore *store = browser->store;
+  MeloRadioNetStoreCategory category;
+  MeloRadioNetBrowserItem *items;
+  const unsigned int *tags = NULL;
+  unsigned int *sorted = NULL;
+  unsigned int i, first, len;
 
-static const char *
-melo_radio_net_browser_get_cover (JsonObject *obj)
+  *count = 0;
 
-{
-  const char *logo;
+  /* Check categories is available */
+  category = melo_radio_net_store_get_category (async->tag);
+  if (category == MELO_RADIO_NET_STORE_CATEGORY_COUNT)
+    return NULL;
 
-  /* Get biggest logo first */
-  if (json_object_has_member (obj, "logo300x300"))
-    logo = json_object_get_string_member (obj, "logo300x300");
-  else if (json_object_has_member (obj, "logo175x175"))
-    logo = json_object_get_string_member (obj, "logo175x175");
-  else if (json_object_has_member (obj, "logo100x100"))
-    logo = json_object_get_string_member (obj, "logo100x100");
-  else if (json_object_has_member (obj, "logo44x44"))
-    logo = json_object_get_string_member (obj, "logo44x44");
+  /* Get categories: filtered by name prefix and / or sorted */
+  if (async->filter) {
+    tags = melo_radio_net_store_find_tags (store, category, async->filter, &len);
+
+    /* Sort matching categories by station count */
+    if (tags && len && async->sort == MELO_RADIO_NET_STORE_SORT_STATIONS) {
+      sorted = malloc (sizeof (*sorted) * len);
+      if (!sorted)
+        return NULL;
+      memcpy (sorted, tags, sizeof (*sorted) * len);
+      melo_radio_net_store_sort_tags (store, sorted, len, async->sort);
+      tags = sorted;
+    }
+  } else if (async->sort != MELO_RADIO_NET_STORE_SORT_NONE)
+    tags = melo_radio_net_store_get_sorted_tags (
+        store, category, async->sort, &len);
   else
+    len = melo_radio_net_store_get_tags (store, category, &first);
+
+  /* Invalid offset */
+  if (len < 1 || async->offset >= len) {
+    free (sorted);
+    return NULL;
+  }
+
+  /* Calculate item list length */
+  len -= async->offset;
+  if (len > async->count)
+    len = async->count;
+
+  /* Allocate item list */
+  items = malloc (sizeof (*items) * len);
+  if (!items) {
+    free (sorted);
+    return NULL;
+  }
+
+  /* Copy categories */
+  for (i = 0; i < len; i++) {
+    unsigned int tag =
+        tags ? tags[async->offset + i] : first + async->offset + i;
+
+    items[i].id = g_strdup (melo_radio_net_store_get_tag_id (store, tag));
+    items[i].name = g_strdup (melo_radio_net_store_get_tag_name (store, tag));
+    items[i].cover = NULL;
+  }
+  free (sorted);
+
+  *count = len;
+  return items;
+}
+
+static MeloRadioNetBrowserItem *
+melo_radio_net_browser_get_station_items (MeloRadioNetBrowser *browser,
+    const unsigned int *stations, unsigned int count)
+{
+  MeloRadioNetStore *store = browser->store;
+  MeloRadioNetBrowserItem *items;
+  unsigned int i;
+
+  if (!stations || count < 1)
     return NULL;
 
-  /* Remove prefix */
-  if (!g_str_has_prefix (logo, MELO_RADIO_NET_BROWSER_ASSET_URL))
+  /* Allocate item list */
+  items = malloc (sizeof (*items) * count);
+  if (!items)
     return NULL;
 
-  return logo + sizeof (MELO_RADIO_NET_BROWSER_ASSET_URL) - 1;
+  /* Copy stations */
+  for (i = 0; i < count; i++) {
+    items[i].id =
+        g_strdup (melo_radio_net_store_get_station_id (store, stations[i]));
+    items[i].name =
+        g_strdup (melo_radio_net_store_get_station_name (store, stations[i]));
+    items[i].cover =
+        g_strdup (melo_radio_net_store_get_station_cover (store, stations[i]));
+  }
+
+  return items;
 }
 
 static MeloMessage *
-category_cb (JsonObject *obj, MeloRequest *req)
+category_cb (MeloRequest *req, MeloRadioNetBrowserItem *list, unsigned int len)
 {
   MeloRadioNetBrowserAsync *async = melo_request_get_user_data (req);
   Browser__Response resp = BROWSER__RESPONSE__INIT;
@@ -132,65 +1808,37 @@ category_cb (JsonObject *obj, MeloRequest *req)
   Browser__Response__MediaItem **items_ptr;
   Browser__Response__MediaItem *items;
   MeloMessage *msg;
-  JsonArray *array;
-  unsigned int i, count, len;
-
-  /* Check categories is available */
-  if (!json_object_has_member (obj, async->tag)) {
-    return NULL;
-  }
+  unsigned int i;
 
-  /* Get categories */
-  array = json_object_get_array_member (obj, async->tag);
-  if (!array || json_array_get_length (array) < 1) {
+  /* Check categories are available */
+  if (!list || len < 1)
     return NULL;
-  }
 
   /* Set response type */
   resp.resp_case = BROWSER__RESPONSE__RESP_MEDIA_LIST;
   resp.media_list = &media_list;
 
-  /* Get array length */
-  len = json_array_get_length (array);
-
-  /* Invalid offset */
-  if (async->offset >= len) {
-    return NULL;
-  }
-
-  /* Calculate item list length */
-  count = len - async->offset;
-  if (count > async->count)
-    count = async->count;
-
   /* Set list count and offset */
-  media_list.count = count;
+  media_list.count = len;
   media_list.offset = async->offset;
 
   /* Allocate item list */
-  items_ptr = malloc (sizeof (*items_ptr) * count);
-  items = malloc (sizeof (*items) * count);
+  items_ptr = malloc (sizeof (*items_ptr) * len);
+  items = malloc (sizeof (*items) * len);
 
   /* Set item list */
-  media_list.n_items = count;
+  media_list.n_items = len;
   media_list.items = items_ptr;
 
   /* Add media items */
-  for (i = 0; i < count; i++) {
-    JsonObject *obj;
-
+  for (i = 0; i < len; i++) {
     /* Init media item */
     browser__response__media_item__init (&items[i]);
     media_list.items[i] = &items[i];
 
-    /* Get next entry */
-    obj = json_array_get_object_element (array, i + async->offset);
-    if (!obj)
-      continue;
-
     /* Set media */
-    items[i].id = (char *) json_object_get_string_member (obj, "systemName");
-    items[i].name = (char *) json_object_get_string_member (obj, "name");
+    items[i].id = list[i].id;
+    items[i].name = list[i].name;
     items[i].type = BROWSER__RESPONSE__MEDIA_ITEM__TYPE__FOLDER;
   }
 
@@ -207,7 +1855,7 @@ category_cb (JsonObject *obj, MeloRequest *req)
 }
 
 static MeloMessage *
-station_cb (JsonObject *obj, MeloRequest *req)
+station_cb (MeloRequest *req, MeloRadioNetBrowserItem *list, unsigned int len)
 {
   static Browser__Action actions[] = {
       {
@@ -241,8 +1889,6 @@ station_cb (JsonObject *obj, MeloRequest *req)
       &actions[2],
       &actions[3],
   };
-  static uint32_t set_fav_actions[] = {0, 1, 2};
-  static uint32_t unset_fav_actions[] = {0, 1, 3};
   MeloRadioNetBrowserAsync *async = melo_request_get_user_data (req);
   Browser__Response resp = BROWSER__RESPONSE__INIT;
   Browser__Response__MediaList media_list = BROWSER__RESPONSE__MEDIA_LIST__INIT;
@@ -250,17 +1896,10 @@ station_cb (JsonObject *obj, MeloRequest *req)
   Browser__Response__MediaItem *items;
   Tags__Tags *tags;
   MeloMessage *msg;
-  JsonArray *array;
-  unsigned int i, len;
-
-  /* Check categories is available */
-  if (!json_object_has_member (obj, "playables")) {
-    return NULL;
-  }
+  unsigned int i;
 
-  /* Get categories */
-  array = json_object_get_array_member (obj, "playables");
-  if (!array || json_array_get_length (array) < 1) {
+  /* Check stations are available */
+  if (!list || len < 1) {
     return NULL;
   }
 
@@ -268,9 +1907,6 @@ station_cb (JsonObject *obj, MeloRequest *req)
   resp.resp_case = BROWSER__RESPONSE__RESP_MEDIA_LIST;
   resp.media_list = &media_list;
 
-  /* Get array length */
-  len = json_array_get_length (array);
-
   /* Set list count and offset */
   media_list.count = len;
   media_list.offset = async->offset;
@@ -290,33 +1926,23 @@ station_cb (JsonObject *obj, MeloRequest *req)
 
   /* Add media items */
   for (i = 0; i < len; i++) {
-    const char *cover;
-    uint64_t id;
-
     /* Init media item */
     browser__response__media_item__init (&items[i]);
     tags__tags__init (&tags[i]);
     media_list.items[i] = &items[i];
 
-    /* Get next station */
-    obj = json_array_get_object_element (array, i);
-    if (!obj)
-      continue;
-
-    /* Set station ID */
-    items[i].id = (char *) json_object_get_string_member (obj, "id");
-
-    /* Set station name */
-    items[i].name = (char *) json_object_get_string_member (obj, "name");
+    /* Set station ID and name */
+    items[i].id = list[i].id;
+    items[i].name = list[i].name;
 
     /* Set media type */
     items[i].type = BROWSER__RESPONSE__MEDIA_ITEM__TYPE__MEDIA;
 
-    /* Set favorite and action IDs */
-    id = melo_library_get_media_id_from_browser (
-        MELO_RADIO_NET_BROWSER_ID, items[i].id);
+    /* Set favorite and action IDs: favorite list mirrors the library */
+    g_mutex_lock (&async->browser->lock);
     items[i].favorite =
-        melo_library_media_get_flags (id) & MELO_LIBRARY_FLAG_FAVORITE;
+        g_hash_table_contains (async->browser->favorites, items[i].id);
+    g_mutex_unlock (&async->browser->lock);
     if (items[i].favorite) {
       items[i].n_action_ids = G_N_ELEMENTS (unset_fav_actions);
       items[i].action_ids = unset_fav_actions;
@@ -329,10 +1955,12 @@ station_cb (JsonObject *obj, MeloRequest *req)
     items[i].tags = &tags[i];
 
     /* Set cover */
-    cover = melo_radio_net_browser_get_cover (obj);
-    if (cover)
+    if (list[i].cover && async->browser->cover_prefix)
+      tags[i].cover =
+          g_strconcat (async->browser->cover_prefix, list[i].cover, NULL);
+    else if (list[i].cover)
       tags[i].cover =
-          melo_tags_gen_cover (melo_request_get_object (req), cover);
+          melo_tags_gen_cover (melo_request_get_object (req), list[i].cover);
   }
 
   /* Pack message */
@@ -340,6 +1968,9 @@ station_cb (JsonObject *obj, MeloRequest *req)
   melo_message_set_size (
       msg, browser__response__pack (&resp, melo_message_get_data (msg)));
 
+  /* Track displayed stations for favorite updates */
+  melo_radio_net_browser_add_visible (async->browser, items_ptr, len);
+
   /* Free item list */
   for (i = 0; i < len; i++) {
     if (tags[i].cover != protobuf_c_empty_string)
@@ -353,35 +1984,210 @@ station_cb (JsonObject *obj, MeloRequest *req)
 }
 
 static void
-list_cb (MeloHttpClient *client, JsonNode *node, void *user_data)
+melo_radio_net_browser_async_free (MeloRadioNetBrowserAsync *async)
 {
-  MeloRequest *req = user_data;
+  g_free (async->tag);
+  g_free (async->filter);
+  g_free (async->url);
+  free (async);
+}
 
-  /* Make media list response from JSON node */
-  if (node) {
-    MeloRadioNetBrowserAsync *async = melo_request_get_user_data (req);
-    MeloMessage *msg = NULL;
+static gboolean
+melo_radio_net_browser_job_done (gpointer user_data)
+{
+  MeloRadioNetBrowserJob *job = user_data;
+  MeloRadioNetBrowser *browser = job->browser;
+  MeloRadioNetBrowserAsync *async;
 
-    /* Save tag list */
-    if (async->tag && !async->browser->tags) {
-      async->browser->tags = json_node_ref (node);
-    }
+  /* Job done */
+  browser->jobs--;
+
+  /* Cache warmer job: save station list in page cache */
+  if (job->warm) {
+    if (job->stations)
+      melo_radio_net_browser_put_page (
+          browser, job->warm->url, job->stations, job->count);
+    melo_radio_net_browser_warm_free (job->warm);
+    free (job->stations);
+    free (job);
+    g_object_unref (browser);
+    return G_SOURCE_REMOVE;
+  }
+  async = melo_request_get_user_data (job->req);
+
+  /* Save station list in page cache */
+  if (async->url && job->stations)
+    melo_radio_net_browser_put_page (
+        browser, async->url, job->stations, job->count);
+
+  /* Generate station list response when covers need the main context */
+  if (job->items)
+    job->msg = station_cb (job->req, job->items, job->n_items);
+  melo_radio_net_browser_items_free (job->items, job->n_items);
+
+  /* Free async object */
+  melo_radio_net_browser_async_free (async);
+
+  /* Send media list response */
+  if (job->msg)
+    melo_request_send_response (job->req, job->msg);
+
+  /* Release request */
+  melo_request_complete (job->req);
+  free (job->stations);
+  free (job);
+
+  /* Enforce memory budget */
+  if (!browser->jobs)
+    melo_radio_net_browser_check_memory (browser);
 
-    /* Parse node as array or object */
+  /* Release browser held by job */
+  g_object_unref (browser);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+melo_radio_net_browser_worker (gpointer data, gpointer user_data)
+{
+  MeloRadioNetBrowserJob *job = data;
+  MeloRadioNetBrowser *browser = job->browser;
+  MeloRadioNetBrowserAsync *async;
+
+  /* Load cache warmer result */
+  if (job->warm) {
+    job->stations =
+        melo_radio_net_browser_load_warm (job->warm, job->node, &job->count);
+    json_node_unref (job->node);
+    g_main_context_invoke (NULL, melo_radio_net_browser_job_done, job);
+    return;
+  }
+  async = melo_request_get_user_data (job->req);
+
+  g_mutex_lock (&browser->store_lock);
+
+  /* Load node into store and copy list items */
+  if (async->tag) {
+    if (job->node && !melo_radio_net_store_has_tags (browser->store))
+      melo_radio_net_browser_load_tags (
+          browser, json_node_get_object (job->node));
+    job->items =
+        melo_radio_net_browser_get_tag_items (browser, async, &job->n_items);
+  } else {
+    if (job->node)
+      job->stations = melo_radio_net_browser_load_stations (
+          browser, json_node_get_object (job->node), &job->count);
+    job->items = melo_radio_net_browser_get_station_items (
+        browser, job->stations, job->count);
+    job->n_items = job->items ? job->count : 0;
+  }
+
+  g_mutex_unlock (&browser->store_lock);
+
+  /* Generate response outside of store lock */
+  if (async->tag || browser->cover_prefix) {
     if (async->tag)
-      msg = category_cb (json_node_get_object (node), req);
+      job->msg = category_cb (job->req, job->items, job->n_items);
     else
-      msg = station_cb (json_node_get_object (node), req);
+      job->msg = station_cb (job->req, job->items, job->n_items);
+    melo_radio_net_browser_items_free (job->items, job->n_items);
+    job->items = NULL;
+    job->n_items = 0;
+  }
+
+  /* Release JSON node */
+  if (job->node)
+    json_node_unref (job->node);
 
-    /* Free async object */
-    g_free (async->tag);
-    free (async);
+  /* Send response from main context */
+  g_main_context_invoke (NULL, melo_radio_net_browser_job_done, job);
+}
+
+static bool
+melo_radio_net_browser_push_job (MeloRequest *req, JsonNode *node,
+    const unsigned int *stations, unsigned int count)
+{
+  MeloRadioNetBrowserAsync *async = melo_request_get_user_data (req);
+  MeloRadioNetBrowserJob *job;
+
+  /* Allocate job */
+  job = malloc (sizeof (*job));
+  if (!job)
+    return false;
+
+  /* Set job */
+  job->browser = async->browser;
+  job->req = req;
+  job->warm = NULL;
+  job->node = node ? json_node_ref (node) : NULL;
+  job->stations = NULL;
+  job->count = 0;
+  job->items = NULL;
+  job->n_items = 0;
+  job->msg = NULL;
+
+  /* Copy cached station list */
+  if (stations) {
+    job->stations = malloc (sizeof (*job->stations) * count);
+    if (!job->stations) {
+      free (job);
+      return false;
+    }
+    memcpy (job->stations, stations, sizeof (*job->stations) * count);
+    job->count = count;
 
-    /* Send media list response */
-    if (msg)
-      melo_request_send_response (req, msg);
+    /* Already in page cache */
+    g_free (async->url);
+    async->url = NULL;
   }
 
+  /* Generate response in worker pool: keep browser until job is done */
+  g_object_ref (async->browser);
+  async->browser->jobs++;
+  g_thread_pool_push (async->browser->pool, job, NULL);
+
+  return true;
+}
+
+static bool
+melo_radio_net_browser_push_warm (MeloRadioNetBrowserWarm *warm, JsonNode *node)
+{
+  MeloRadioNetBrowserJob *job;
+
+  /* Allocate job */
+  job = calloc (1, sizeof (*job));
+  if (!job)
+    return false;
+
+  /* Set job */
+  job->browser = warm->browser;
+  job->warm = warm;
+  job->node = json_node_ref (node);
+
+  /* Load result in worker pool: keep browser until job is done */
+  g_object_ref (warm->browser);
+  warm->browser->jobs++;
+  g_thread_pool_push (warm->browser->pool, job, NULL);
+
+  return true;
+}
+
+static void
+list_cb (MeloHttpClient *client, JsonNode *node, void *user_data)
+{
+  MeloRequest *req = user_data;
+  MeloRadioNetBrowserAsync *async = melo_request_get_user_data (req);
+
+  /* Remote request done */
+  async->browser->pending--;
+
+  /* Make media list response from JSON node */
+  if (node && melo_radio_net_browser_push_job (req, node, NULL, 0))
+    return;
+
+  /* Free async object */
+  melo_radio_net_browser_async_free (async);
+
   /* Release request */
   melo_request_complete (req);
 }
@@ -451,12 +2257,35 @@ melo_radio_net_browser_get_root (MeloRequest *req)
   return true;
 }
 
+static void
+melo_radio_net_browser_parse_options (
+    MeloRadioNetBrowserAsync *async, const char *options)
+{
+  char **opts;
+  unsigned int i;
+
+  /* Parse category options: filter=<prefix>&sort=<name|count> */
+  opts = g_strsplit (options, "&", -1);
+  for (i = 0; opts[i]; i++) {
+    if (g_str_has_prefix (opts[i], "filter=")) {
+      g_free (async->filter);
+      async->filter = g_uri_unescape_string (opts[i] + 7, NULL);
+    } else if (!g_strcmp0 (opts[i], "sort=name"))
+      async->sort = MELO_RADIO_NET_STORE_SORT_NAME;
+    else if (!g_strcmp0 (opts[i], "sort=count"))
+      async->sort = MELO_RADIO_NET_STORE_SORT_STATIONS;
+  }
+  g_strfreev (opts);
+}
+
 static bool
 melo_radio_net_browser_get_media_list (MeloRadioNetBrowser *browser,
     Browser__Request__GetMediaList *r, MeloRequest *req)
 {
+  MeloRadioNetBrowserPage *page;
   MeloRadioNetBrowserAsync *async;
   const char *query = r->query;
+  bool has_tags;
   char *url;
   bool search = false;
   bool ret;
@@ -473,6 +2302,9 @@ melo_radio_net_browser_get_media_list (MeloRadioNetBrowser *browser,
   /* Set async object */
   async->browser = browser;
   async->tag = NULL;
+  async->filter = NULL;
+  async->sort = MELO_RADIO_NET_STORE_SORT_NONE;
+  async->url = NULL;
   async->offset = r->offset;
   async->count = r->count;
   melo_request_set_user_data (req, async);
@@ -493,23 +2325,44 @@ melo_radio_net_browser_get_media_list (MeloRadioNetBrowser *browser,
 
     /* Generate URL */
     if (!q || *q == '\0') {
-      /* Save current category */
+      char *o;
+
+      /* Split category options */
+      o = strchr (query, '?');
+      if (o)
+        *o++ = '\0';
+
+      /* Save current category and options */
       async->tag = g_strdup (query);
+      if (o)
+        melo_radio_net_browser_parse_options (async, o);
 
       /* Use cache */
-      if (browser->tags) {
-        list_cb (browser->client, browser->tags, req);
-        return true;
-      }
+      g_mutex_lock (&browser->store_lock);
+      has_tags = melo_radio_net_store_has_tags (browser->store);
+      g_mutex_unlock (&browser->store_lock);
+      if (has_tags)
+        return melo_radio_net_browser_push_job (req, NULL, NULL, 0);
 
       /* Create category URL */
-      url = g_strdup_printf (MELO_RADIO_NET_BROWSER_URL "stations/tags");
+      url = g_strdup ("stations/tags");
     } else {
+      char *o;
+
       /* Create sub-category URL */
       *q++ = '\0';
-      url = g_strdup_printf (MELO_RADIO_NET_BROWSER_URL
+
+      /* Drop category options */
+      o = strchr (query, '?');
+      if (o)
+        *o = '\0';
+      url = g_strdup_printf (
           "stations/by-tag?systemName=%s&tagType=%s&count=%d&offset=%d",
           q, query, r->count, r->offset);
+
+      /* Count first page requests for cache warmer */
+      if (!r->offset)
+        melo_radio_net_browser_add_history (browser, url);
     }
   } else {
     char *q, *p;
@@ -523,29 +2376,133 @@ melo_radio_net_browser_get_media_list (MeloRadioNetBrowser *browser,
     }
 
     /* Create search URL */
-    url = g_strdup_printf (MELO_RADIO_NET_BROWSER_URL
-        "stations/search?query=%s&count=%d&offset=%d",
+    url = g_strdup_printf ("stations/search?query=%s&count=%d&offset=%d",
         q, r->count, r->offset);
     g_free (q);
   }
 
+  /* Use page cache */
+  page = melo_radio_net_browser_get_page (browser, url);
+  if (page) {
+    g_free (url);
+    return melo_radio_net_browser_push_job (
+        req, NULL, page->stations, page->count);
+  }
+
   MELO_LOGD ("get_media_list: %s", url);
 
+  /* Keep station list URL for page cache */
+  if (!async->tag)
+    async->url = g_strdup (url);
+
   /* Get list from URL */
-  ret = melo_http_client_get_json (browser->client, url, list_cb, req);
+  ret = melo_radio_net_browser_get_json (browser, url, list_cb, req);
+  if (ret)
+    browser->pending++;
   g_free (url);
 
   return ret;
 }
 
+static void
+melo_radio_net_browser_station_action (
+    MeloRadioNetBrowser *browser, MeloRequest *req, unsigned int station)
+{
+  Browser__Action__Type type;
+  char *id, *name, *url, *cover;
+  MeloTags *tags = NULL;
+
+  /* Get station from store */
+  g_mutex_lock (&browser->store_lock);
+  id = g_strdup (melo_radio_net_store_get_station_id (browser->store, station));
+  name = g_strdup (
+      melo_radio_net_store_get_station_name (browser->store, station));
+  url = g_strdup (
+      melo_radio_net_store_get_station_stream (browser->store, station));
+  cover = g_strdup (
+      melo_radio_net_store_get_station_cover (browser->store, station));
+  g_mutex_unlock (&browser->store_lock);
+
+  /* Get tags from station */
+  if (cover) {
+    tags = melo_tags_new ();
+    if (tags) {
+      melo_tags_set_cover (tags, melo_request_get_object (req), cover);
+      melo_tags_set_browser (tags, MELO_RADIO_NET_BROWSER_ID);
+      melo_tags_set_media_id (tags, id);
+    }
+  }
+
+  MELO_LOGD ("play radio %s: %s", name, url);
+
+  /* Get action type */
+  type = (uintptr_t) melo_request_get_user_data (req);
+
+  /* Do action */
+  if (type == BROWSER__ACTION__TYPE__PLAY)
+    melo_playlist_play_media (RADIO_PLAYER_ID, url, name, tags);
+  else if (type == BROWSER__ACTION__TYPE__ADD)
+    melo_playlist_add_media (RADIO_PLAYER_ID, url, name, tags);
+  else {
+    char *path, *media;
+    bool ret = false;
+
+    /* Separate path */
+    path = g_strdup (url);
+    media = strrchr (path, '/');
+    if (media)
+      *media++ = '\0';
+
+    /* Set / unset favorite marker */
+    if (type == BROWSER__ACTION__TYPE__UNSET_FAVORITE) {
+      uint64_t media_id;
+
+      /* Get media ID */
+      media_id =
+          melo_library_get_media_id (RADIO_PLAYER_ID, 0, path, 0, media);
+
+      /* Unset favorite */
+      ret = melo_library_update_media_flags (
+          media_id, MELO_LIBRARY_FLAG_FAVORITE_ONLY, true);
+    } else if (type == BROWSER__ACTION__TYPE__SET_FAVORITE)
+      /* Set favorite */
+      ret = melo_library_add_media (RADIO_PLAYER_ID, 0, path, 0, media, 0,
+          MELO_LIBRARY_SELECT (COVER), name, tags, 0,
+          MELO_LIBRARY_FLAG_FAVORITE_ONLY);
+
+    /* Update favorite list and notify clients of new state */
+    if (ret) {
+      melo_radio_net_browser_set_favorite (
+          browser, id, type == BROWSER__ACTION__TYPE__SET_FAVORITE);
+      melo_radio_net_browser_send_favorite (
+          browser, id, type == BROWSER__ACTION__TYPE__SET_FAVORITE);
+    } else
+      MELO_LOGW ("failed to update favorite %s", name);
+
+    /* Free resources */
+    g_free (path);
+    melo_tags_unref (tags);
+  }
+
+  /* Free station */
+  g_free (id);
+  g_free (name);
+  g_free (url);
+  g_free (cover);
+}
+
 static void
 action_cb (MeloHttpClient *client, JsonNode *node, void *user_data)
 {
   MeloRequest *req = user_data;
+  MeloRadioNetBrowser *browser =
+      MELO_RADIO_NET_BROWSER (melo_request_get_object (req));
+
+  /* Remote request done */
+  browser->pending--;
 
   /* Extract radio URL from JSON node */
   if (node) {
-    Browser__Action__Type type;
     JsonObject *obj = NULL;
     JsonArray *array;
 
@@ -558,81 +2515,16 @@ action_cb (MeloHttpClient *client, JsonNode *node, void *user_data)
 
     /* Get object */
     if (obj) {
-      const char *name, *url = NULL, *cover;
-      unsigned int i, count;
-      MeloTags *tags = NULL;
-      JsonArray *urls;
-
-      /* Get station name */
-      name = json_object_get_string_member (obj, "name");
-
-      /* Get station URL */
-      urls = json_object_get_array_member (obj, "streams");
-      count = json_array_get_length (urls);
-      for (i = 0; i < count; i++) {
-        JsonObject *o;
-
-        /* Get next object */
-        o = json_array_get_object_element (urls, i);
-        if (!o || !json_object_has_member (o, "url"))
-          continue;
-
-        /* Get URL */
-        url = json_object_get_string_member (o, "url");
-        break;
-      }
+      unsigned int station;
 
-      /* Get tags from object */
-      cover = melo_radio_net_browser_get_cover (obj);
-      if (cover) {
-        tags = melo_tags_new ();
-        if (tags) {
-          melo_tags_set_cover (tags, melo_request_get_object (req), cover);
-          melo_tags_set_browser (tags, MELO_RADIO_NET_BROWSER_ID);
-          melo_tags_set_media_id (
-              tags, (char *) json_object_get_string_member (obj, "id"));
-        }
-      }
+      /* Save station details in store */
+      g_mutex_lock (&browser->store_lock);
+      station = melo_radio_net_browser_load_station (browser, obj);
+      g_mutex_unlock (&browser->store_lock);
 
-      MELO_LOGD ("play radio %s: %s", name, url);
-
-      /* Get action type */
-      type = (uintptr_t) melo_request_get_user_data (req);
-
-      /* Do action */
-      if (type == BROWSER__ACTION__TYPE__PLAY)
-        melo_playlist_play_media (RADIO_PLAYER_ID, url, name, tags);
-      else if (type == BROWSER__ACTION__TYPE__ADD)
-        melo_playlist_add_media (RADIO_PLAYER_ID, url, name, tags);
-      else {
-        char *path, *media;
-
-        /* Separate path */
-        path = g_strdup (url);
-        media = strrchr (path, '/');
-        if (media)
-          *media++ = '\0';
-
-        /* Set / unset favorite marker */
-        if (type == BROWSER__ACTION__TYPE__UNSET_FAVORITE) {
-          uint64_t id;
-
-          /* Get media ID */
-          id = melo_library_get_media_id (RADIO_PLAYER_ID, 0, path, 0, media);
-
-          /* Unset favorite */
-          melo_library_update_media_flags (
-              id, MELO_LIBRARY_FLAG_FAVORITE_ONLY, true);
-        } else if (type == BROWSER__ACTION__TYPE__SET_FAVORITE)
-          /* Set favorite */
-          melo_library_add_media (RADIO_PLAYER_ID, 0, path, 0, media, 0,
-              MELO_LIBRARY_SELECT (COVER), name, tags, 0,
-              MELO_LIBRARY_FLAG_FAVORITE_ONLY);
-
-        /* Free resources */
-        g_free (path);
-        melo_tags_unref (tags);
-      }
+      /* Do action on station */
+      if (station != MELO_RADIO_NET_STORE_INVALID)
+        melo_radio_net_browser_station_action (browser, req, station);
     }
   }
 
@@ -645,6 +2537,7 @@ melo_radio_net_browser_do_action (MeloRadioNetBrowser *browser,
     Browser__Request__DoAction *r, MeloRequest *req)
 {
   const char *path = r->path;
+  unsigned int station;
   const char *id;
   char *url;
   bool ret;
@@ -670,17 +2563,52 @@ melo_radio_net_browser_do_action (MeloRadioNetBrowser *browser,
   /* Save action type in request */
   melo_request_set_user_data (req, (void *) r->type);
 
+  /* Use station from store when its stream URL is recent */
+  g_mutex_lock (&browser->store_lock);
+  station = melo_radio_net_store_find_station (browser->store, id);
+  if (melo_radio_net_store_get_station_stream_age (browser->store, station) >=
+      MELO_RADIO_NET_BROWSER_STREAM_TTL)
+    station = MELO_RADIO_NET_STORE_INVALID;
+  g_mutex_unlock (&browser->store_lock);
+  if (station != MELO_RADIO_NET_STORE_INVALID) {
+    melo_radio_net_browser_station_action (browser, req, station);
+    melo_request_complete (req);
+    return true;
+  }
+
   /* Generate URL from path */
-  url = g_strdup_printf (
-      MELO_RADIO_NET_BROWSER_URL "stations/details?stationIds=%s", id);
+  url = g_strdup_printf ("stations/details?stationIds=%s", id);
 
   /* Get radio URL from sparod */
-  ret = melo_http_client_get_json (browser->client, url, action_cb, req);
+  ret = melo_radio_net_browser_get_json (browser, url, action_cb, req);
+  if (ret)
+    browser->pending++;
   g_free (url);
 
   return ret;
 }
 
+static void
+melo_radio_net_browser_check_cover (MeloRadioNetBrowser *browser)
+{
+  char *prefix, *cover, *expected;
+
+  browser->cover_checked = true;
+
+  /* Generated cover must be the asset ID with a constant prefix */
+  prefix = melo_tags_gen_cover (G_OBJECT (browser), "");
+  cover = melo_tags_gen_cover (G_OBJECT (browser), "id");
+  expected = g_strconcat (prefix ? prefix : "", "id", NULL);
+  if (prefix && !g_strcmp0 (cover, expected))
+    browser->cover_prefix = g_strdup (prefix);
+  else
+    MELO_LOGW ("covers are generated from main context");
+
+  free (prefix);
+  free (cover);
+  g_free (expected);
+}
+
 static bool
 melo_radio_net_browser_handle_request (
     MeloBrowser *browser, const MeloMessage *msg, MeloRequest *req)
@@ -697,6 +2625,13 @@ melo_radio_net_browser_handle_request (
     return false;
   }
 
+  /* Postpone cache warmer */
+  rbrowser->last_request = g_get_monotonic_time ();
+
+  /* Get cover prefix for worker pool */
+  if (!rbrowser->cover_checked)
+    melo_radio_net_browser_check_cover (rbrowser);
+
   /* Handle request */
   switch (r->req_case) {
   case BROWSER__REQUEST__REQ_GET_MEDIA_LIST:
@@ -719,5 +2654,15 @@ melo_radio_net_browser_handle_request (
 static char *
 melo_radio_net_browser_get_asset (MeloBrowser *browser, const char *id)
 {
-  return g_strconcat (MELO_RADIO_NET_BROWSER_ASSET_URL, id, NULL);
+  MeloRadioNetBrowser *rbrowser = MELO_RADIO_NET_BROWSER (browser);
+  char *url;
+
+  /* Use first asset endpoint: asset fetch result is not reported back */
+  g_mutex_lock (&rbrowser->endpoints_lock);
+  url = g_strconcat (
+      melo_radio_net_endpoints_get_url (rbrowser->asset_endpoints, 0), id,
+      NULL);
+  g_mutex_unlock (&rbrowser->endpoints_lock);
+
+  return url;
 }
@@ -24,6 +24,9 @@ G_BEGIN_DECLS
 
 #define MELO_RADIO_NET_BROWSER_ID "net.radio.browser"
 
+/* Default memory budget of caches, in bytes */
+#define MELO_RADIO_NET_BROWSER_MEMORY_BUDGET (8 * 1024 * 1024)
+
 #define MELO_RADIO_NET_BROWSER_ICON \
   "svg:<svg viewBox=\"0 0 172 172\"><g transform=\"translate(-40 -33)\"><g " \
   "transform=\"translate(40.623 33.379)\"><path d=\"m48.727 63.736c-3.78 " \
@@ -56,6 +59,76 @@ MELO_DECLARE_BROWSER (
  */
 MeloRadioNetBrowser *melo_radio_net_browser_new (void);
 
+/**
+ * Stop the background tasks of the radio.net browser.
+ *
+ * The cache warmer and the favorite checker are stopped, and the pending
+ * stream probes are cancelled. It must be called when the module is disabled,
+ * since pending requests may keep the browser alive after its last release.
+ *
+ * @param browser the radio.net browser
+ */
+void melo_radio_net_browser_stop (MeloRadioNetBrowser *browser);
+
+/**
+ * Set the radio.net API and asset endpoints.
+ *
+ * Each list is a comma separated list of base URLs, such as a local caching
+ * mirror followed by the official servers. Every API request is sent to the
+ * fastest healthy endpoint, and an endpoint failing repeatedly is disabled for
+ * a while. Station logos are always fetched from the first asset URL: the
+ * others are only used to recognize the logo URLs sent by the directory.
+ *
+ * @param browser the radio.net browser
+ * @param urls the API base URL list, or NULL for the default one
+ * @param asset_urls the asset (station logos) base URL list, or NULL for the
+ *     default one
+ * @return true if the endpoints have been set, false otherwise.
+ */
+bool melo_radio_net_browser_set_endpoints (
+    MeloRadioNetBrowser *browser, const char *urls, const char *asset_urls);
+
+/**
+ * MeloRadioNetBrowserMemory:
+ * @budget: the memory budget
+ * @pages: the memory used by the station list page cache
+ * @stations: the memory used by the station store
+ * @tags: the memory used by the tag catalogue
+ * @lists: the memory used by the history, displayed and favorite lists
+ *
+ * Approximate memory usage of the browser caches, in bytes.
+ */
+typedef struct {
+  size_t budget;
+  size_t pages;
+  size_t stations;
+  size_t tags;
+  size_t lists;
+} MeloRadioNetBrowserMemory;
+
+/**
+ * Get the memory used by the radio.net browser caches.
+ *
+ * @param browser the radio.net browser
+ * @param mem a pointer to a #MeloRadioNetBrowserMemory to fill
+ */
+void melo_radio_net_browser_get_memory (
+    MeloRadioNetBrowser *browser, MeloRadioNetBrowserMemory *mem);
+
+/**
+ * Set the memory budget of the radio.net browser caches.
+ *
+ * When the caches grow over the budget, the expired and oldest pages are
+ * dropped first with the stations they reference, then the tag catalogue.
+ * Favorite stations are always kept. The memory usage is logged periodically.
+ *
+ * @param browser the radio.net browser
+ * @param budget the memory budget, in bytes
+ * @return true if the budget has been set, false otherwise.
+ */
+bool melo_radio_net_browser_set_memory_budget (
+    MeloRadioNetBrowser *browser, size_t budget);
+
 G_END_DECLS
 
 #endif /* !_MELO_RADIO_NET_BROWSER_H_ */
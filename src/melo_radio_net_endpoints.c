@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2020 Alexandre Dilly <dillya@sparod.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ */
+
+#include <string.h>
+
+#define MELO_LOG_TAG "radio_net_endpoints"
+#include <melo/melo_log.h>
+
+#include "melo_radio_net_endpoints.h"
+
+/* Weight of the last request in the average latency */
+#define MELO_RADIO_NET_ENDPOINTS_EWMA_ALPHA 0.2
+/* Consecutive failures before an endpoint is put in cool-down */
+#define MELO_RADIO_NET_ENDPOINTS_MAX_FAILURES 3
+/* Cool-down duration, in seconds */
+#define MELO_RADIO_NET_ENDPOINTS_COOLDOWN 30
+
+typedef struct {
+  char *url;
+  double latency;
+  bool measured;
+  unsigned int failures;
+  gint64 cooldown;
+} MeloRadioNetEndpoint;
+
+struct _MeloRadioNetEndpoints {
+  MeloRadioNetEndpoint *list;
+  unsigned int count;
+};
+
+MeloRadioNetEndpoints *
+melo_radio_net_endpoints_new (const char *urls)
+{
+  MeloRadioNetEndpoints *endpoints;
+  char **list;
+  unsigned int i;
+
+  if (!urls)
+    return NULL;
+
+  /* Split URL list */
+  list = g_strsplit (urls, ",", -1);
+
+  /* Allocate endpoint list */
+  endpoints = g_new0 (MeloRadioNetEndpoints, 1);
+  endpoints->list = g_new0 (MeloRadioNetEndpoint, g_strv_length (list));
+
+  /* Add endpoints */
+  for (i = 0; list[i]; i++) {
+    const char *url = g_strstrip (list[i]);
+
+    if (*url == '\0')
+      continue;
+
+    /* Endpoint list is full */
+    if (endpoints->count == MELO_RADIO_NET_ENDPOINTS_MAX) {
+      MELO_LOGW ("too many endpoints, %s ignored", url);
+      continue;
+    }
+
+    /* Base URL must end with a slash */
+    endpoints->list[endpoints->count++].url = g_str_has_suffix (url, "/")
+                                                  ? g_strdup (url)
+                                                  : g_strconcat (url, "/", NULL);
+  }
+  g_strfreev (list);
+
+  /* No valid URL */
+  if (!endpoints->count) {
+    melo_radio_net_endpoints_free (endpoints);
+    return NULL;
+  }
+
+  return endpoints;
+}
+
+void
+melo_radio_net_endpoints_free (MeloRadioNetEndpoints *endpoints)
+{
+  unsigned int i;
+
+  if (!endpoints)
+    return;
+
+  for (i = 0; i < endpoints->count; i++)
+    g_free (endpoints->list[i].url);
+  g_free (endpoints->list);
+  g_free (endpoints);
+}
+
+unsigned int
+melo_radio_net_endpoints_get_count (MeloRadioNetEndpoints *endpoints)
+{
+  return endpoints->count;
+}
+
+const char *
+melo_radio_net_endpoints_get_url (
+    MeloRadioNetEndpoints *endpoints, unsigned int index)
+{
+  return index < endpoints->count ? endpoints->list[index].url : NULL;
+}
+
+unsigned int
+melo_radio_net_endpoints_select (
+    MeloRadioNetEndpoints *endpoints, guint64 exclude)
+{
+  unsigned int i, best = MELO_RADIO_NET_ENDPOINTS_INVALID;
+  unsigned int next = MELO_RADIO_NET_ENDPOINTS_INVALID;
+  gint64 now = g_get_monotonic_time ();
+
+  for (i = 0; i < endpoints->count; i++) {
+    MeloRadioNetEndpoint *ep = &endpoints->list[i];
+
+    if (exclude & ((guint64) 1 << i))
+      continue;
+
+    /* Endpoint in cool-down: keep the one available first */
+    if (ep->cooldown > now) {
+      if (next == MELO_RADIO_NET_ENDPOINTS_INVALID ||
+          ep->cooldown < endpoints->list[next].cooldown)
+        next = i;
+      continue;
+    }
+
+    /* Try endpoints never used first, then the fastest */
+    if (best == MELO_RADIO_NET_ENDPOINTS_INVALID ||
+        (!ep->measured && endpoints->list[best].measured) ||
+        (ep->measured == endpoints->list[best].measured &&
+            ep->latency < endpoints->list[best].latency))
+      best = i;
+  }
+
+  return best != MELO_RADIO_NET_ENDPOINTS_INVALID ? best : next;
+}
+
+void
+melo_radio_net_endpoints_report (MeloRadioNetEndpoints *endpoints,
+    unsigned int index, bool success, gint64 latency)
+{
+  MeloRadioNetEndpoint *ep;
+
+  if (index >= endpoints->count)
+    return;
+  ep = &endpoints->list[index];
+
+  /* Request failed */
+  if (!success) {
+    /* Open circuit after too many failures */
+    if (++ep->failures >= MELO_RADIO_NET_ENDPOINTS_MAX_FAILURES) {
+      ep->cooldown = g_get_monotonic_time () +
+                     MELO_RADIO_NET_ENDPOINTS_COOLDOWN * G_USEC_PER_SEC;
+      MELO_LOGW ("endpoint %s disabled for %d s", ep->url,
+          MELO_RADIO_NET_ENDPOINTS_COOLDOWN);
+    }
+    return;
+  }
+
+  /* Update average latency */
+  if (ep->measured)
+    ep->latency = MELO_RADIO_NET_ENDPOINTS_EWMA_ALPHA * latency +
+                  (1.0 - MELO_RADIO_NET_ENDPOINTS_EWMA_ALPHA) * ep->latency;
+  else
+    ep->latency = latency;
+  ep->measured = true;
+
+  /* Close circuit */
+  ep->failures = 0;
+  ep->cooldown = 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 Alexandre Dilly <dillya@sparod.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ */
+
+#ifndef _MELO_RADIO_NET_ENDPOINTS_H_
+#define _MELO_RADIO_NET_ENDPOINTS_H_
+
+#include <stdbool.h>
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define MELO_RADIO_NET_ENDPOINTS_INVALID G_MAXUINT
+#define MELO_RADIO_NET_ENDPOINTS_MAX 64
+
+typedef struct _MeloRadioNetEndpoints MeloRadioNetEndpoints;
+
+/**
+ * Create a new endpoint list.
+ *
+ * The list is parsed from a comma separated list of base URLs. Each base URL
+ * must end with a '/', which is added if missing. Only the first
+ * MELO_RADIO_NET_ENDPOINTS_MAX URLs are used.
+ *
+ * @param urls the comma separated list of base URLs
+ * @return the newly endpoint list or NULL if @urls contains no URL.
+ */
+MeloRadioNetEndpoints *melo_radio_net_endpoints_new (const char *urls);
+
+/**
+ * Release an endpoint list.
+ *
+ * @param endpoints the endpoint list to free
+ */
+void melo_radio_net_endpoints_free (MeloRadioNetEndpoints *endpoints);
+
+/**
+ * Get the number of endpoints.
+ *
+ * @param endpoints the endpoint list
+ * @return the number of endpoints.
+ */
+unsigned int melo_radio_net_endpoints_get_count (
+    MeloRadioNetEndpoints *endpoints);
+
+/**
+ * Get the base URL of an endpoint.
+ *
+ * @param endpoints the endpoint list
+ * @param index the endpoint index
+ * @return the base URL or NULL.
+ */
+const char *melo_radio_net_endpoints_get_url (
+    MeloRadioNetEndpoints *endpoints, unsigned int index);
+
+/**
+ * Select the endpoint to use for the next request.
+ *
+ * The healthy endpoint with the lowest average latency is selected; endpoints
+ * never used are tried first. An endpoint with too many consecutive failures
+ * is skipped until its cool-down expires. If all endpoints are failing, the
+ * one whose cool-down expires first is returned.
+ *
+ * @param endpoints the endpoint list
+ * @param exclude a mask of endpoint indexes to skip (bit n for index n), or 0
+ * @return the endpoint index or MELO_RADIO_NET_ENDPOINTS_INVALID if no endpoint
+ *     is available.
+ */
+unsigned int melo_radio_net_endpoints_select (
+    MeloRadioNetEndpoints *endpoints, guint64 exclude);
+
+/**
+ * Report the result of a request on an endpoint.
+ *
+ * @param endpoints the endpoint list
+ * @param index the endpoint index
+ * @param success true if the request succeeded
+ * @param latency the request duration, in microseconds
+ */
+void melo_radio_net_endpoints_report (MeloRadioNetEndpoints *endpoints,
+    unsigned int index, bool success, gint64 latency);
+
+G_END_DECLS
+
+#endif /* !_MELO_RADIO_NET_ENDPOINTS_H_ */
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2020 Alexandre Dilly <dillya@sparod.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ */
+
+#include <libsoup/soup.h>
+
+#define MELO_LOG_TAG "radio_net_prober"
+#include <melo/melo_log.h>
+
+#include "melo_radio_net_prober.h"
+
+#define MELO_RADIO_NET_PROBER_TIMEOUT 10
+
+struct _MeloRadioNetProber {
+  SoupSession *session;
+};
+
+typedef struct {
+  MeloRadioNetProber *prober;
+  char **urls;
+  unsigned int index;
+  MeloRadioNetProberCb cb;
+  void *user_data;
+} MeloRadioNetProberCheck;
+
+static bool melo_radio_net_prober_next (MeloRadioNetProberCheck *check);
+
+MeloRadioNetProber *
+melo_radio_net_prober_new (const char *user_agent)
+{
+  MeloRadioNetProber *prober;
+
+  /* Allocate prober */
+  prober = g_new0 (MeloRadioNetProber, 1);
+
+  /* Create HTTP session */
+  prober->session = soup_session_new_with_options (SOUP_SESSION_USER_AGENT,
+      user_agent, SOUP_SESSION_TIMEOUT, MELO_RADIO_NET_PROBER_TIMEOUT, NULL);
+  if (!prober->session) {
+    g_free (prober);
+    return NULL;
+  }
+
+  return prober;
+}
+
+void
+melo_radio_net_prober_free (MeloRadioNetProber *prober)
+{
+  if (!prober)
+    return;
+
+  /* Cancel pending probes */
+  soup_session_abort (prober->session);
+  g_object_unref (prober->session);
+  g_free (prober);
+}
+
+static bool
+melo_radio_net_prober_is_alive (guint status)
+{
+  /* Stream is served */
+  if (SOUP_STATUS_IS_SUCCESSFUL (status) || SOUP_STATUS_IS_REDIRECTION (status))
+    return true;
+
+  /* Stream server doesn't support HEAD */
+  return status == SOUP_STATUS_METHOD_NOT_ALLOWED ||
+         status == SOUP_STATUS_NOT_IMPLEMENTED;
+}
+
+static void
+melo_radio_net_prober_done (MeloRadioNetProberCheck *check, const char *url)
+{
+  /* Signal result */
+  check->cb (url, check->user_data);
+
+  /* Free check */
+  g_strfreev (check->urls);
+  g_free (check);
+}
+
+static void
+probe_cb (SoupSession *session, SoupMessage *msg, gpointer user_data)
+{
+  MeloRadioNetProberCheck *check = user_data;
+  const char *url = check->urls[check->index];
+
+  /* Stream is alive */
+  if (melo_radio_net_prober_is_alive (msg->status_code)) {
+    melo_radio_net_prober_done (check, url);
+    return;
+  }
+
+  MELO_LOGD ("stream %s is dead: %u", url, msg->status_code);
+
+  /* Prober released */
+  if (msg->status_code == SOUP_STATUS_CANCELLED) {
+    melo_radio_net_prober_done (check, NULL);
+    return;
+  }
+
+  /* Probe next URL */
+  check->index++;
+  if (!melo_radio_net_prober_next (check))
+    melo_radio_net_prober_done (check, NULL);
+}
+
+static bool
+melo_radio_net_prober_next (MeloRadioNetProberCheck *check)
+{
+  SoupMessage *msg = NULL;
+
+  /* Find next valid URL */
+  while (check->urls[check->index]) {
+    msg = soup_message_new (SOUP_METHOD_HEAD, check->urls[check->index]);
+    if (msg)
+      break;
+    check->index++;
+  }
+  if (!msg)
+    return false;
+
+  /* Send probe request */
+  soup_session_queue_message (check->prober->session, msg, probe_cb, check);
+
+  return true;
+}
+
+bool
+melo_radio_net_prober_check (MeloRadioNetProber *prober,
+    const char *const *urls, MeloRadioNetProberCb cb, void *user_data)
+{
+  MeloRadioNetProberCheck *check;
+
+  if (!prober || !urls || !cb)
+    return false;
+
+  /* Allocate check */
+  check = g_new0 (MeloRadioNetProberCheck, 1);
+  check->prober = prober;
+  check->urls = g_strdupv ((char **) urls);
+  check->cb = cb;
+  check->user_data = user_data;
+
+  /* Start with first URL */
+  if (!melo_radio_net_prober_next (check)) {
+    g_strfreev (check->urls);
+    g_free (check);
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2020 Alexandre Dilly <dillya@sparod.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ */
+
+#ifndef _MELO_RADIO_NET_PROBER_H_
+#define _MELO_RADIO_NET_PROBER_H_
+
+#include <stdbool.h>
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _MeloRadioNetProber MeloRadioNetProber;
+
+/* Called once with the first live stream URL, or NULL if all are dead */
+typedef void (*MeloRadioNetProberCb) (const char *url, void *user_data);
+
+/**
+ * Create a new stream prober.
+ *
+ * @param user_agent the user agent to use for probe requests
+ * @return the newly prober or NULL.
+ */
+MeloRadioNetProber *melo_radio_net_prober_new (const char *user_agent);
+
+/**
+ * Release a stream prober.
+ *
+ * The callbacks of pending checks are called with a NULL URL.
+ *
+ * @param prober the prober to free
+ */
+void melo_radio_net_prober_free (MeloRadioNetProber *prober);
+
+/**
+ * Find the first live stream in a URL list.
+ *
+ * The URLs are probed one after the other with a HEAD request, until a server
+ * answers with a success or a redirection, or with 405 or 501 when it doesn't
+ * support HEAD requests.
+ *
+ * @param prober the prober
+ * @param urls a NULL terminated list of stream URLs
+ * @param cb the function to call when done
+ * @param user_data the data to pass to @cb
+ * @return true if the check has started, false otherwise.
+ */
+bool melo_radio_net_prober_check (MeloRadioNetProber *prober,
+    const char *const *urls, MeloRadioNetProberCb cb, void *user_data);
+
+G_END_DECLS
+
+#endif /* !_MELO_RADIO_NET_PROBER_H_ */
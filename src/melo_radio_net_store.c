@@ -0,0 +1,609 @@
+/*
+ * Copyright (C) 2020 Alexandre Dilly <dillya@sparod.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ */
+
+#include <string.h>
+
+#include "melo_radio_net_store.h"
+
+#define MELO_RADIO_NET_STORE_CHUNK_SIZE 16384
+#define MELO_RADIO_NET_STORE_MIN_ALLOC 64
+
+struct _MeloRadioNetStore {
+  /* Interned strings */
+  GStringChunk *chunk;
+  GHashTable *strings;
+  size_t strings_size;
+  size_t tag_strings_size;
+
+  /* Stations: one array per field, indexed by handle */
+  GHashTable *station_ids;
+  unsigned int station_count;
+  unsigned int station_alloc;
+  const char **station_id;
+  const char **station_name;
+  const char **station_cover;
+  const char **station_stream;
+  guint32 *station_time;
+
+  /* Tags: one array per field, indexed by handle */
+  unsigned int tag_count;
+  unsigned int tag_alloc;
+  const char **tag_id;
+  const char **tag_name;
+  const char **tag_key;
+  guint32 *tag_stations;
+  unsigned int *tag_by_name;
+  unsigned int *tag_by_stations;
+  unsigned int category_first[MELO_RADIO_NET_STORE_CATEGORY_COUNT];
+  unsigned int category_count[MELO_RADIO_NET_STORE_CATEGORY_COUNT];
+};
+
+static const char *melo_radio_net_store_categories[] = {
+    [MELO_RADIO_NET_STORE_GENRES] = "genres",
+    [MELO_RADIO_NET_STORE_TOPICS] = "topics",
+    [MELO_RADIO_NET_STORE_COUNTRIES] = "countries",
+    [MELO_RADIO_NET_STORE_LANGUAGES] = "languages",
+    [MELO_RADIO_NET_STORE_CITIES] = "cities",
+};
+
+MeloRadioNetStore *
+melo_radio_net_store_new (void)
+{
+  MeloRadioNetStore *store;
+
+  /* Allocate store */
+  store = g_new0 (MeloRadioNetStore, 1);
+
+  /* Create string pool and station index */
+  store->chunk = g_string_chunk_new (MELO_RADIO_NET_STORE_CHUNK_SIZE);
+  store->strings = g_hash_table_new (g_str_hash, g_str_equal);
+  store->station_ids = g_hash_table_new (g_str_hash, g_str_equal);
+
+  return store;
+}
+
+void
+melo_radio_net_store_free (MeloRadioNetStore *store)
+{
+  if (!store)
+    return;
+
+  /* Free station arrays */
+  g_free (store->station_id);
+  g_free (store->station_name);
+  g_free (store->station_cover);
+  g_free (store->station_stream);
+  g_free (store->station_time);
+
+  /* Free tag arrays */
+  melo_radio_net_store_clear_tags (store);
+
+  /* Free strings */
+  g_hash_table_unref (store->station_ids);
+  g_hash_table_unref (store->strings);
+  g_string_chunk_free (store->chunk);
+  g_free (store);
+}
+
+MeloRadioNetStoreCategory
+melo_radio_net_store_get_category (const char *name)
+{
+  unsigned int i;
+
+  for (i = 0; i < MELO_RADIO_NET_STORE_CATEGORY_COUNT; i++)
+    if (!g_strcmp0 (name, melo_radio_net_store_categories[i]))
+      return i;
+
+  return MELO_RADIO_NET_STORE_CATEGORY_COUNT;
+}
+
+const char *
+melo_radio_net_store_get_category_name (MeloRadioNetStoreCategory category)
+{
+  if (category >= MELO_RADIO_NET_STORE_CATEGORY_COUNT)
+    return NULL;
+
+  return melo_radio_net_store_categories[category];
+}
+
+static const char *
+melo_radio_net_store_intern (MeloRadioNetStore *store, const char *str)
+{
+  char *s;
+
+  if (!str)
+    return NULL;
+
+  /* Already interned */
+  s = g_hash_table_lookup (store->strings, str);
+  if (s)
+    return s;
+
+  /* Add string to pool */
+  s = g_string_chunk_insert (store->chunk, str);
+  g_hash_table_add (store->strings, s);
+  store->strings_size += strlen (s) + 1;
+
+  return s;
+}
+
+static guint32
+melo_radio_net_store_now (void)
+{
+  return g_get_monotonic_time () / G_USEC_PER_SEC;
+}
+
+unsigned int
+melo_radio_net_store_add_station (MeloRadioNetStore *store, const char *id,
+    const char *name, const char *cover, const char *stream)
+{
+  unsigned int handle;
+  gpointer value;
+
+  if (!id)
+    return MELO_RADIO_NET_STORE_INVALID;
+
+  /* Find existing station */
+  if (g_hash_table_lookup_extended (store->station_ids, id, NULL, &value)) {
+    handle = GPOINTER_TO_UINT (value);
+  } else {
+    /* Grow arrays */
+    if (store->station_count == store->station_alloc) {
+      unsigned int alloc = store->station_alloc * 2;
+
+      if (alloc < MELO_RADIO_NET_STORE_MIN_ALLOC)
+        alloc = MELO_RADIO_NET_STORE_MIN_ALLOC;
+
+      store->station_id = g_renew (const char *, store->station_id, alloc);
+      store->station_name = g_renew (const char *, store->station_name, alloc);
+      store->station_cover =
+          g_renew (const char *, store->station_cover, alloc);
+      store->station_stream =
+          g_renew (const char *, store->station_stream, alloc);
+      store->station_time = g_renew (guint32, store->station_time, alloc);
+      store->station_alloc = alloc;
+    }
+
+    /* Add new station */
+    handle = store->station_count++;
+    store->station_id[handle] = melo_radio_net_store_intern (store, id);
+    store->station_name[handle] = NULL;
+    store->station_cover[handle] = NULL;
+    store->station_stream[handle] = NULL;
+    store->station_time[handle] = 0;
+    g_hash_table_insert (store->station_ids,
+        (gpointer) store->station_id[handle], GUINT_TO_POINTER (handle));
+  }
+
+  /* Update fields */
+  if (name)
+    store->station_name[handle] = melo_radio_net_store_intern (store, name);
+  if (cover)
+    store->station_cover[handle] = melo_radio_net_store_intern (store, cover);
+  if (stream) {
+    store->station_stream[handle] =
+        melo_radio_net_store_intern (store, stream);
+    store->station_time[handle] = melo_radio_net_store_now ();
+  }
+
+  return handle;
+}
+
+unsigned int
+melo_radio_net_store_find_station (MeloRadioNetStore *store, const char *id)
+{
+  gpointer value;
+
+  if (!id ||
+      !g_hash_table_lookup_extended (store->station_ids, id, NULL, &value))
+    return MELO_RADIO_NET_STORE_INVALID;
+
+  return GPOINTER_TO_UINT (value);
+}
+
+unsigned int
+melo_radio_net_store_get_station_count (MeloRadioNetStore *store)
+{
+  return store->station_count;
+}
+
+const char *
+melo_radio_net_store_get_station_id (
+    MeloRadioNetStore *store, unsigned int handle)
+{
+  return handle < store->station_count ? store->station_id[handle] : NULL;
+}
+
+const char *
+melo_radio_net_store_get_station_name (
+    MeloRadioNetStore *store, unsigned int handle)
+{
+  return handle < store->station_count ? store->station_name[handle] : NULL;
+}
+
+const char *
+melo_radio_net_store_get_station_cover (
+    MeloRadioNetStore *store, unsigned int handle)
+{
+  return handle < store->station_count ? store->station_cover[handle] : NULL;
+}
+
+const char *
+melo_radio_net_store_get_station_stream (
+    MeloRadioNetStore *store, unsigned int handle)
+{
+  return handle < store->station_count ? store->station_stream[handle] : NULL;
+}
+
+unsigned int
+melo_radio_net_store_get_station_stream_age (
+    MeloRadioNetStore *store, unsigned int handle)
+{
+  if (handle >= store->station_count || !store->station_stream[handle])
+    return G_MAXUINT;
+
+  return melo_radio_net_store_now () - store->station_time[handle];
+}
+
+unsigned int
+melo_radio_net_store_add_tag (MeloRadioNetStore *store,
+    MeloRadioNetStoreCategory category, const char *id, const char *name,
+    unsigned int stations)
+{
+  unsigned int handle;
+  char *key;
+
+  if (category >= MELO_RADIO_NET_STORE_CATEGORY_COUNT || !id)
+    return MELO_RADIO_NET_STORE_INVALID;
+
+  /* Tags of a category must be contiguous */
+  if (!store->category_count[category])
+    store->category_first[category] = store->tag_count;
+  else if (store->category_first[category] + store->category_count[category] !=
+           store->tag_count)
+    return MELO_RADIO_NET_STORE_INVALID;
+
+  /* Grow arrays */
+  if (store->tag_count == store->tag_alloc) {
+    unsigned int alloc = store->tag_alloc * 2;
+
+    if (alloc < MELO_RADIO_NET_STORE_MIN_ALLOC)
+      alloc = MELO_RADIO_NET_STORE_MIN_ALLOC;
+
+    store->tag_id = g_renew (const char *, store->tag_id, alloc);
+    store->tag_name = g_renew (const char *, store->tag_name, alloc);
+    store->tag_key = g_renew (const char *, store->tag_key, alloc);
+    store->tag_stations = g_renew (guint32, store->tag_stations, alloc);
+    store->tag_alloc = alloc;
+  }
+
+  /* Add tag */
+  handle = store->tag_count++;
+  store->tag_id[handle] = melo_radio_net_store_intern (store, id);
+  store->tag_name[handle] = melo_radio_net_store_intern (store, name);
+  store->tag_stations[handle] = stations;
+
+  /* Add case-folded name for sorting and prefix search */
+  key = g_utf8_casefold (name ? name : id, -1);
+  store->tag_key[handle] = melo_radio_net_store_intern (store, key);
+  g_free (key);
+
+  /* Account tag strings, even if shared */
+  store->tag_strings_size += strlen (store->tag_id[handle]) +
+                             strlen (store->tag_key[handle]) + 2;
+  if (store->tag_name[handle])
+    store->tag_strings_size += strlen (store->tag_name[handle]) + 1;
+  store->category_count[category]++;
+
+  return handle;
+}
+
+void
+melo_radio_net_store_clear_tags (MeloRadioNetStore *store)
+{
+  /* Release tag arrays: strings stay in pool */
+  g_free (store->tag_id);
+  g_free (store->tag_name);
+  g_free (store->tag_key);
+  g_free (store->tag_stations);
+  g_free (store->tag_by_name);
+  g_free (store->tag_by_stations);
+  store->tag_id = NULL;
+  store->tag_name = NULL;
+  store->tag_key = NULL;
+  store->tag_stations = NULL;
+  store->tag_by_name = NULL;
+  store->tag_by_stations = NULL;
+  store->tag_count = store->tag_alloc = 0;
+  store->tag_strings_size = 0;
+
+  /* Reset categories */
+  memset (store->category_first, 0, sizeof (store->category_first));
+  memset (store->category_count, 0, sizeof (store->category_count));
+}
+
+static gint
+tag_name_cmp (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  MeloRadioNetStore *store = user_data;
+  unsigned int ta = *(const unsigned int *) a, tb = *(const unsigned int *) b;
+  int ret;
+
+  ret = strcmp (store->tag_key[ta], store->tag_key[tb]);
+  return ret ? ret : (ta > tb) - (ta < tb);
+}
+
+static gint
+tag_stations_cmp (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  MeloRadioNetStore *store = user_data;
+  unsigned int ta = *(const unsigned int *) a, tb = *(const unsigned int *) b;
+
+  /* Most stations first, then alphabetical */
+  if (store->tag_stations[ta] != store->tag_stations[tb])
+    return store->tag_stations[ta] < store->tag_stations[tb] ? 1 : -1;
+
+  return tag_name_cmp (a, b, user_data);
+}
+
+void
+melo_radio_net_store_sort_tags (MeloRadioNetStore *store, unsigned int *tags,
+    unsigned int count, MeloRadioNetStoreSort sort)
+{
+  if (sort == MELO_RADIO_NET_STORE_SORT_NAME)
+    g_qsort_with_data (tags, count, sizeof (*tags), tag_name_cmp, store);
+  else if (sort == MELO_RADIO_NET_STORE_SORT_STATIONS)
+    g_qsort_with_data (tags, count, sizeof (*tags), tag_stations_cmp, store);
+}
+
+void
+melo_radio_net_store_index_tags (MeloRadioNetStore *store)
+{
+  unsigned int i;
+
+  /* Allocate indexes */
+  g_free (store->tag_by_name);
+  g_free (store->tag_by_stations);
+  store->tag_by_name = g_new (unsigned int, store->tag_count);
+  store->tag_by_stations = g_new (unsigned int, store->tag_count);
+  for (i = 0; i < store->tag_count; i++)
+    store->tag_by_name[i] = store->tag_by_stations[i] = i;
+
+  /* Sort each category in place */
+  for (i = 0; i < MELO_RADIO_NET_STORE_CATEGORY_COUNT; i++) {
+    unsigned int first = store->category_first[i];
+    unsigned int count = store->category_count[i];
+
+    melo_radio_net_store_sort_tags (store, store->tag_by_name + first, count,
+        MELO_RADIO_NET_STORE_SORT_NAME);
+    melo_radio_net_store_sort_tags (store, store->tag_by_stations + first,
+        count, MELO_RADIO_NET_STORE_SORT_STATIONS);
+  }
+}
+
+const unsigned int *
+melo_radio_net_store_get_sorted_tags (MeloRadioNetStore *store,
+    MeloRadioNetStoreCategory category, MeloRadioNetStoreSort sort,
+    unsigned int *count)
+{
+  unsigned int *index;
+
+  *count = 0;
+
+  if (category >= MELO_RADIO_NET_STORE_CATEGORY_COUNT)
+    return NULL;
+
+  /* Get index */
+  if (sort == MELO_RADIO_NET_STORE_SORT_NAME)
+    index = store->tag_by_name;
+  else if (sort == MELO_RADIO_NET_STORE_SORT_STATIONS)
+    index = store->tag_by_stations;
+  else
+    return NULL;
+  if (!index)
+    return NULL;
+
+  *count = store->category_count[category];
+  return index + store->category_first[category];
+}
+
+const unsigned int *
+melo_radio_net_store_find_tags (MeloRadioNetStore *store,
+    MeloRadioNetStoreCategory category, const char *prefix,
+    unsigned int *count)
+{
+  const unsigned int *tags;
+  unsigned int len, lo, hi, mid, start;
+  size_t plen;
+  char *key;
+
+  /* Get name index */
+  tags = melo_radio_net_store_get_sorted_tags (
+      store, category, MELO_RADIO_NET_STORE_SORT_NAME, &len);
+  *count = len;
+  if (!tags || !prefix)
+    return tags;
+
+  /* Case-fold prefix */
+  key = g_utf8_casefold (prefix, -1);
+  plen = strlen (key);
+
+  /* Find first name not lower than prefix */
+  lo = 0;
+  hi = len;
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (strcmp (store->tag_key[tags[mid]], key) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  start = lo;
+
+  /* Find first name after the names starting with prefix */
+  hi = len;
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (strncmp (store->tag_key[tags[mid]], key, plen) <= 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  g_free (key);
+
+  *count = lo - start;
+  return tags + start;
+}
+
+bool
+melo_radio_net_store_has_tags (MeloRadioNetStore *store)
+{
+  return store->tag_count > 0;
+}
+
+unsigned int
+melo_radio_net_store_get_tags (MeloRadioNetStore *store,
+    MeloRadioNetStoreCategory category, unsigned int *first)
+{
+  if (category >= MELO_RADIO_NET_STORE_CATEGORY_COUNT)
+    return 0;
+
+  if (first)
+    *first = store->category_first[category];
+
+  return store->category_count[category];
+}
+
+const char *
+melo_radio_net_store_get_tag_id (MeloRadioNetStore *store, unsigned int handle)
+{
+  return handle < store->tag_count ? store->tag_id[handle] : NULL;
+}
+
+const char *
+melo_radio_net_store_get_tag_name (
+    MeloRadioNetStore *store, unsigned int handle)
+{
+  return handle < store->tag_count ? store->tag_name[handle] : NULL;
+}
+
+unsigned int
+melo_radio_net_store_get_tag_stations (
+    MeloRadioNetStore *store, unsigned int handle)
+{
+  return handle < store->tag_count ? store->tag_stations[handle] : 0;
+}
+
+unsigned int
+melo_radio_net_store_compact (
+    MeloRadioNetStore *store, const bool *keep, unsigned int *remap)
+{
+  GStringChunk *chunk = store->chunk;
+  GHashTable *strings = store->strings;
+  unsigned int i, count = 0;
+
+  /* Create new string pool */
+  store->chunk = g_string_chunk_new (MELO_RADIO_NET_STORE_CHUNK_SIZE);
+  store->strings = g_hash_table_new (g_str_hash, g_str_equal);
+  store->strings_size = 0;
+  g_hash_table_remove_all (store->station_ids);
+
+  /* Move kept stations and their strings */
+  for (i = 0; i < store->station_count; i++) {
+    if (!keep[i]) {
+      if (remap)
+        remap[i] = MELO_RADIO_NET_STORE_INVALID;
+      continue;
+    }
+
+    store->station_id[count] =
+        melo_radio_net_store_intern (store, store->station_id[i]);
+    store->station_name[count] =
+        melo_radio_net_store_intern (store, store->station_name[i]);
+    store->station_cover[count] =
+        melo_radio_net_store_intern (store, store->station_cover[i]);
+    store->station_stream[count] =
+        melo_radio_net_store_intern (store, store->station_stream[i]);
+    store->station_time[count] = store->station_time[i];
+    g_hash_table_insert (store->station_ids,
+        (gpointer) store->station_id[count], GUINT_TO_POINTER (count));
+    if (remap)
+      remap[i] = count;
+    count++;
+  }
+  store->station_count = count;
+
+  /* Shrink station arrays */
+  if (count < store->station_alloc / 2) {
+    unsigned int alloc = MAX (count, MELO_RADIO_NET_STORE_MIN_ALLOC);
+
+    store->station_id = g_renew (const char *, store->station_id, alloc);
+    store->station_name = g_renew (const char *, store->station_name, alloc);
+    store->station_cover = g_renew (const char *, store->station_cover, alloc);
+    store->station_stream =
+        g_renew (const char *, store->station_stream, alloc);
+    store->station_time = g_renew (guint32, store->station_time, alloc);
+    store->station_alloc = alloc;
+  }
+
+  /* Move tag strings */
+  for (i = 0; i < store->tag_count; i++) {
+    store->tag_id[i] = melo_radio_net_store_intern (store, store->tag_id[i]);
+    store->tag_name[i] =
+        melo_radio_net_store_intern (store, store->tag_name[i]);
+    store->tag_key[i] = melo_radio_net_store_intern (store, store->tag_key[i]);
+  }
+
+  /* Release old string pool */
+  g_hash_table_unref (strings);
+  g_string_chunk_free (chunk);
+
+  return count;
+}
+
+size_t
+melo_radio_net_store_get_size (MeloRadioNetStore *store)
+{
+  size_t size = sizeof (*store);
+
+  /* Station and tag arrays */
+  size += store->station_alloc * (4 * sizeof (const char *) + sizeof (guint32));
+  size += store->tag_alloc * (3 * sizeof (const char *) + sizeof (guint32));
+  if (store->tag_by_name)
+    size += store->tag_count * 2 * sizeof (unsigned int);
+
+  /* Interned strings and indexes (about 3 words per hash table entry) */
+  size += store->strings_size;
+  size += (g_hash_table_size (store->strings) +
+              g_hash_table_size (store->station_ids)) *
+          3 * sizeof (gpointer);
+
+  return size;
+}
+
+size_t
+melo_radio_net_store_get_tags_size (MeloRadioNetStore *store)
+{
+  size_t size;
+
+  /* Tag arrays and indexes */
+  size = store->tag_alloc * (3 * sizeof (const char *) + sizeof (guint32));
+  if (store->tag_by_name)
+    size += store->tag_count * 2 * sizeof (unsigned int);
+
+  return size + store->tag_strings_size;
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2020 Alexandre Dilly <dillya@sparod.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 2.1 of the License, or any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ */
+
+#ifndef _MELO_RADIO_NET_STORE_H_
+#define _MELO_RADIO_NET_STORE_H_
+
+#include <stdbool.h>
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define MELO_RADIO_NET_STORE_INVALID G_MAXUINT
+
+typedef struct _MeloRadioNetStore MeloRadioNetStore;
+
+/* Tag categories of the radio.net directory */
+typedef enum {
+  MELO_RADIO_NET_STORE_GENRES = 0,
+  MELO_RADIO_NET_STORE_TOPICS,
+  MELO_RADIO_NET_STORE_COUNTRIES,
+  MELO_RADIO_NET_STORE_LANGUAGES,
+  MELO_RADIO_NET_STORE_CITIES,
+
+  MELO_RADIO_NET_STORE_CATEGORY_COUNT,
+} MeloRadioNetStoreCategory;
+
+/* Tag sort orders */
+typedef enum {
+  MELO_RADIO_NET_STORE_SORT_NONE = 0,
+  MELO_RADIO_NET_STORE_SORT_NAME,
+  MELO_RADIO_NET_STORE_SORT_STATIONS,
+} MeloRadioNetStoreSort;
+
+/**
+ * Create a new station and tag store.
+ *
+ * All strings are interned and each station or tag is referenced by an integer
+ * handle. The store is not thread-safe: the caller must serialize accesses.
+ *
+ * @return the newly store or NULL.
+ */
+MeloRadioNetStore *melo_radio_net_store_new (void);
+
+/**
+ * Release a store and all its strings.
+ *
+ * @param store the store to free
+ */
+void melo_radio_net_store_free (MeloRadioNetStore *store);
+
+/**
+ * Get the category from its name.
+ *
+ * @param name the category name (e.g. "genres")
+ * @return the category or MELO_RADIO_NET_STORE_CATEGORY_COUNT if not found.
+ */
+MeloRadioNetStoreCategory melo_radio_net_store_get_category (const char *name);
+
+/**
+ * Get the name of a category, as used in the tag catalogue.
+ *
+ * @param category the category
+ * @return the category name.
+ */
+const char *melo_radio_net_store_get_category_name (
+    MeloRadioNetStoreCategory category);
+
+/**
+ * Add or update a station.
+ *
+ * If a station with the same @id is already stored, the same handle is
+ * returned and its fields are updated with all non-NULL values.
+ *
+ * @param store the store
+ * @param id the station ID
+ * @param name the station name, or NULL
+ * @param cover the station cover asset ID, or NULL
+ * @param stream the station stream URL, or NULL
+ * @return the station handle or MELO_RADIO_NET_STORE_INVALID.
+ */
+unsigned int melo_radio_net_store_add_station (MeloRadioNetStore *store,
+    const char *id, const char *name, const char *cover, const char *stream);
+
+/**
+ * Find a station from its ID.
+ *
+ * @param store the store
+ * @param id the station ID
+ * @return the station handle or MELO_RADIO_NET_STORE_INVALID.
+ */
+unsigned int melo_radio_net_store_find_station (
+    MeloRadioNetStore *store, const char *id);
+
+/**
+ * Get the number of stations in the store.
+ *
+ * @param store the store
+ * @return the station count.
+ */
+unsigned int melo_radio_net_store_get_station_count (MeloRadioNetStore *store);
+
+/* Station fields: strings are valid until the store is released */
+const char *melo_radio_net_store_get_station_id (
+    MeloRadioNetStore *store, unsigned int handle);
+const char *melo_radio_net_store_get_station_name (
+    MeloRadioNetStore *store, unsigned int handle);
+const char *melo_radio_net_store_get_station_cover (
+    MeloRadioNetStore *store, unsigned int handle);
+const char *melo_radio_net_store_get_station_stream (
+    MeloRadioNetStore *store, unsigned int handle);
+
+/**
+ * Get the age of the station stream URL.
+ *
+ * @param store the store
+ * @param handle the station handle
+ * @return the number of seconds since the stream URL was last set, or
+ *     G_MAXUINT if no stream URL is known.
+ */
+unsigned int melo_radio_net_store_get_station_stream_age (
+    MeloRadioNetStore *store, unsigned int handle);
+
+/**
+ * Add a tag to a category.
+ *
+ * Tags of a category must be added contiguously, after a call to
+ * melo_radio_net_store_clear_tags(). When all tags are added,
+ * melo_radio_net_store_index_tags() must be called to build the sorted indexes.
+ *
+ * @param store the store
+ * @param category the tag category
+ * @param id the tag system name
+ * @param name the tag display name
+ * @param stations the number of stations with this tag
+ * @return the tag handle or MELO_RADIO_NET_STORE_INVALID.
+ */
+unsigned int melo_radio_net_store_add_tag (MeloRadioNetStore *store,
+    MeloRadioNetStoreCategory category, const char *id, const char *name,
+    unsigned int stations);
+
+/**
+ * Build the sorted indexes of all tags.
+ *
+ * @param store the store
+ */
+void melo_radio_net_store_index_tags (MeloRadioNetStore *store);
+
+/**
+ * Remove all tags from the store.
+ *
+ * @param store the store
+ */
+void melo_radio_net_store_clear_tags (MeloRadioNetStore *store);
+
+/**
+ * Check if the tag catalogue is loaded.
+ *
+ * @param store the store
+ * @return true if at least one tag is stored.
+ */
+bool melo_radio_net_store_has_tags (MeloRadioNetStore *store);
+
+/**
+ * Get the tag handle range of a category.
+ *
+ * Tag handles of a category are contiguous, from @first to @first + count - 1.
+ *
+ * @param store the store
+ * @param category the tag category
+ * @param first a pointer to store the first tag handle
+ * @return the number of tags in the category.
+ */
+unsigned int melo_radio_net_store_get_tags (MeloRadioNetStore *store,
+    MeloRadioNetStoreCategory category, unsigned int *first);
+
+/**
+ * Get the tags of a category, in a sort order.
+ *
+ * @param store the store
+ * @param category the tag category
+ * @param sort the sort order, MELO_RADIO_NET_STORE_SORT_NONE is not supported
+ * @param count a pointer to store the number of tags
+ * @return the sorted tag handle array, owned by the store, or NULL.
+ */
+const unsigned int *melo_radio_net_store_get_sorted_tags (
+    MeloRadioNetStore *store, MeloRadioNetStoreCategory category,
+    MeloRadioNetStoreSort sort, unsigned int *count);
+
+/**
+ * Find the tags of a category with a name starting with a prefix.
+ *
+ * The prefix is matched case-insensitively with a binary search in the name
+ * index, and the matching tags are returned in alphabetical order.
+ *
+ * @param store the store
+ * @param category the tag category
+ * @param prefix the name prefix
+ * @param count a pointer to store the number of matching tags
+ * @return the tag handle array, owned by the store, or NULL.
+ */
+const unsigned int *melo_radio_net_store_find_tags (MeloRadioNetStore *store,
+    MeloRadioNetStoreCategory category, const char *prefix,
+    unsigned int *count);
+
+/**
+ * Sort an array of tag handles.
+ *
+ * @param store the store
+ * @param tags the tag handle array to sort
+ * @param count the number of tags
+ * @param sort the sort order
+ */
+void melo_radio_net_store_sort_tags (MeloRadioNetStore *store,
+    unsigned int *tags, unsigned int count, MeloRadioNetStoreSort sort);
+
+/* Tag fields: strings are valid until the store is released */
+const char *melo_radio_net_store_get_tag_id (
+    MeloRadioNetStore *store, unsigned int handle);
+const char *melo_radio_net_store_get_tag_name (
+    MeloRadioNetStore *store, unsigned int handle);
+unsigned int melo_radio_net_store_get_tag_stations (
+    MeloRadioNetStore *store, unsigned int handle);
+
+/**
+ * Remove stations and release the strings not used anymore.
+ *
+ * All station handles may change: @remap is filled with the new handle of each
+ * station, or MELO_RADIO_NET_STORE_INVALID if it has been removed. All strings
+ * previously returned by the store are invalidated.
+ *
+ * @param store the store
+ * @param keep an array with one entry per station, true to keep it
+ * @param remap an array with one entry per station to store the new handles,
+ *     or NULL
+ * @return the number of stations left in the store.
+ */
+unsigned int melo_radio_net_store_compact (
+    MeloRadioNetStore *store, const bool *keep, unsigned int *remap);
+
+/**
+ * Get the memory used by the store.
+ *
+ * @param store the store
+ * @return the approximate size in bytes of the store.
+ */
+size_t melo_radio_net_store_get_size (MeloRadioNetStore *store);
+
+/**
+ * Get the memory used by the tag catalogue in the store.
+ *
+ * @param store the store
+ * @return the approximate size in bytes of the tags, included in
+ *     melo_radio_net_store_get_size().
+ */
+size_t melo_radio_net_store_get_tags_size (MeloRadioNetStore *store);
+
+G_END_DECLS
+
+#endif /* !_MELO_RADIO_NET_STORE_H_ */